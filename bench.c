@@ -0,0 +1,167 @@
+/**
+ * @file bench.c
+ * @brief Throughput benchmark for the `bench` make target
+ *
+ * Drives sha256_append/sha256_finish across message sizes from 64 B to
+ * 1 GiB and reports GB/s (and cycles/byte where a cycle counter exists)
+ * for the backend selected on this host, plus the multi-buffer path.
+ * The thread is pinned and each size runs a calibrated timing loop.
+ */
+
+#if defined(__linux__)
+    #define _GNU_SOURCE
+    #include <sched.h>
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sha256.h"
+
+#if defined(__x86_64__)
+    #include <x86intrin.h>
+#endif
+
+// Run each size for at least this long so short messages get sane numbers
+#define BENCH_MIN_NSEC (250 * 1000 * 1000ull)
+
+static uint64_t nsec_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return 1000000000ull * (uint64_t)ts.tv_sec + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t cycles_now(void)
+{
+#if defined(__x86_64__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t cnt;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(cnt));
+    return cnt;
+#else
+    return 0;
+#endif
+}
+
+static void pin_thread(void)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(0, &set);
+    (void)sched_setaffinity(0, sizeof(set), &set);
+#endif
+}
+
+// Keep the compiler from hoisting the whole loop away
+static volatile uint8_t sink;
+
+static void bench_single(const uint8_t *buf, size_t len)
+{
+    uint64_t bytes = 0;
+    uint64_t iters = 0;
+
+    const uint64_t t0 = nsec_now();
+    const uint64_t c0 = cycles_now();
+    uint64_t t1;
+    do {
+        sha256_t ctx;
+        sha256_init(&ctx);
+        sha256_append(&ctx, buf, len);
+        uint8_t digest[32];
+        sha256_finish(&ctx, digest);
+        sink = digest[0];
+        bytes += len;
+        iters++;
+        t1 = nsec_now();
+    } while (t1 - t0 < BENCH_MIN_NSEC);
+    const uint64_t c1 = cycles_now();
+
+    const double secs = (double)(t1 - t0) / 1e9;
+    const double gbs = (double)bytes / secs / 1e9;
+    const double cpb = bytes ? (double)(c1 - c0) / (double)bytes : 0.0;
+    printf("%12zu B  %10.3f GB/s  %8.3f cycles/B  (%llu iters)\n",
+           len, gbs, cpb, (unsigned long long)iters);
+}
+
+static void bench_nway(const uint8_t *buf, size_t len, size_t count)
+{
+    const void **srcs = malloc(count * sizeof(void *));
+    size_t *lens = malloc(count * sizeof(size_t));
+    uint8_t (*digests)[32] = malloc(32 * count);
+    if (!srcs || !lens || !digests) {
+        free(srcs);
+        free(lens);
+        free(digests);
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        srcs[i] = &buf[len * i];
+        lens[i] = len;
+    }
+
+    uint64_t bytes = 0;
+    const uint64_t t0 = nsec_now();
+    const uint64_t c0 = cycles_now();
+    uint64_t t1;
+    do {
+        sha256_hash_nway(srcs, lens, count, digests);
+        sink = digests[0][0];
+        bytes += len * count;
+        t1 = nsec_now();
+    } while (t1 - t0 < BENCH_MIN_NSEC);
+    const uint64_t c1 = cycles_now();
+
+    const double secs = (double)(t1 - t0) / 1e9;
+    printf("%4zu x %6zu B  %10.3f GB/s  %8.3f cycles/B\n",
+           count, len, (double)bytes / secs / 1e9, (double)(c1 - c0) / (double)bytes);
+
+    free(srcs);
+    free(lens);
+    free(digests);
+}
+
+int main(void)
+{
+    pin_thread();
+
+    // Take the largest buffer we can get, up to 1 GiB
+    size_t cap = 1024u * 1024 * 1024;
+    uint8_t *buf = NULL;
+    while (!(buf = malloc(cap)) && cap > 64) {
+        cap /= 2;
+    }
+    if (!buf) {
+        fprintf(stderr, "bench: out of memory\n");
+        return 1;
+    }
+    memset(buf, 0xa5, cap);
+
+    printf("backend: %s\n\n", sha256_backend());
+
+    printf("single stream (sha256_append/sha256_finish):\n");
+    static const size_t sizes[] = {
+        64, 256, 1024, 4096, 16384, 65536,
+        1024 * 1024, 16 * 1024 * 1024, 256 * 1024 * 1024, 1024 * 1024 * 1024
+    };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        if (sizes[i] > cap) {
+            break;
+        }
+        bench_single(buf, sizes[i]);
+    }
+
+    printf("\nmulti-buffer (sha256_hash_nway):\n");
+    if (cap >= 8 * 65536) {
+        bench_nway(buf, 4096, 8);
+        bench_nway(buf, 65536, 8);
+    }
+
+    free(buf);
+    return 0;
+}
@@ -12,6 +12,64 @@
 
 #include "sha256.h"
 
+#include <stdlib.h>
+
+// Compile-time backend pinning for fixed targets: define exactly one of
+// SHA256_BACKEND_SCALAR / SHA256_BACKEND_SHANI / SHA256_BACKEND_ARMV8 to
+// compile a single kernel with no runtime detection and no
+// function-pointer indirection — sha256_compress becomes a direct call
+// and every other backend drops out of the binary
+#if defined(SHA256_BACKEND_SCALAR) + defined(SHA256_BACKEND_SHANI) + defined(SHA256_BACKEND_ARMV8) > 1
+    #error "define at most one SHA256_BACKEND_* macro"
+#endif
+
+#if defined(SHA256_BACKEND_SCALAR) || defined(SHA256_BACKEND_SHANI) || defined(SHA256_BACKEND_ARMV8)
+    #define SHA256_BACKEND_PINNED 1
+#else
+    #define SHA256_BACKEND_PINNED 0
+#endif
+
+#if !SHA256_BACKEND_PINNED || defined(SHA256_BACKEND_SCALAR)
+    #define SHA256_KERNEL_SCALAR 1
+#endif
+
+#if defined(__x86_64__) && defined(__GNUC__)
+    #if !SHA256_BACKEND_PINNED || defined(SHA256_BACKEND_SHANI)
+        #define SHA256_KERNEL_SHANI 1
+    #endif
+    #if !SHA256_BACKEND_PINNED
+        #define SHA256_KERNEL_AVX2 1
+    #endif
+    #include <immintrin.h>
+    #include <cpuid.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define SHA256_POSIX 1
+    #include <dirent.h>
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <pthread.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #include <stdio.h>
+#endif
+
+// Pinning the ARMv8 kernel skips the getauxval probe, so it works on
+// bare-metal targets where the crypto extensions are a known quantity
+#if (defined(__aarch64__) && defined(__GNUC__) && defined(__linux__) && !SHA256_BACKEND_PINNED) || defined(SHA256_BACKEND_ARMV8)
+    #define SHA256_KERNEL_ARMV8 1
+    #include <arm_neon.h>
+    #if !SHA256_BACKEND_PINNED
+        #include <sys/auxv.h>
+        #ifndef HWCAP_SHA2
+            #define HWCAP_SHA2 (1 << 6)
+        #endif
+    #endif
+#endif
+
 // SHR(x, n) (3.2.3)
 static inline uint32_t shr(uint32_t x, uint32_t n)
 {
@@ -61,111 +119,659 @@ static inline uint32_t sig1(uint32_t x)
     return rotr(x, 0x11) ^ rotr(x, 0x13) ^ shr(x, 0x0a);
 }
 
+// (4.2.2)
+static const uint32_t k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+// (5.3.2)
+static const uint32_t sha256_iv[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
 void sha256_init(sha256_t *ctx)
 {
     memset(ctx, 0, sizeof(sha256_t));
+    memcpy(ctx->state, sha256_iv, sizeof(sha256_iv));
+}
 
-    // (5.3.2)
-    ctx->state[0] = 0x6a09e667;
-    ctx->state[1] = 0xbb67ae85;
-    ctx->state[2] = 0x3c6ef372;
-    ctx->state[3] = 0xa54ff53a;
-    ctx->state[4] = 0x510e527f;
-    ctx->state[5] = 0x9b05688c;
-    ctx->state[6] = 0x1f83d9ab;
-    ctx->state[7] = 0x5be0cd19;
-}
-
-static void sha256_hash(sha256_t *ctx, const uint8_t *data)
-{
-    // (4.2.2)
-    static const uint32_t k[64] = {
-        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-    };
+void sha256_reset(sha256_t *ctx)
+{
+    // Skip the staging buffer: pad only writes from block_bytes onward,
+    // so stale bytes below it never reach the compression function
+    memcpy(ctx->state, sha256_iv, sizeof(sha256_iv));
+    ctx->bits_total = 0;
+    ctx->block_bytes = 0;
+}
+
+// One round of (6.2.2.3) — callers rotate the working variables through
+// the parameter list instead of rotating the variables themselves
+#define SHA256_ROUND(w, a, b, c, d, e, f, g, h, i)                        \
+    do {                                                                  \
+        const uint32_t t1 = h + sum1(e) + ch(e, f, g) + k[i] + w[i];      \
+        const uint32_t t2 = sum0(a) + maj(a, b, c);                       \
+        d += t1;                                                          \
+        h = t1 + t2;                                                      \
+    } while (0)
+
+// Same round, but with k[i] + w[i] already folded into one table — used
+// where the message block is a compile-time constant
+#define SHA256_ROUND_WK(wk, a, b, c, d, e, f, g, h, i)                    \
+    do {                                                                  \
+        const uint32_t t1 = h + sum1(e) + ch(e, f, g) + wk[i];            \
+        const uint32_t t2 = sum0(a) + maj(a, b, c);                       \
+        d += t1;                                                          \
+        h = t1 + t2;                                                      \
+    } while (0)
+
+// Big-endian 32-bit load (5.2.1). Little-endian hosts get one wide load
+// plus a byte swap; the memcpy keeps it strict-aliasing-safe and
+// alignment-agnostic, and compilers fold the pair into mov+bswap (or a
+// single movbe/rev). Other byte orders keep the portable assembly.
+static inline uint32_t sha256_load_be32(const uint8_t *src)
+{
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint32_t word;
+    memcpy(&word, src, sizeof(word));
+    return __builtin_bswap32(word);
+#else
+    return (uint32_t)src[0] << 0x18 |
+           (uint32_t)src[1] << 0x10 |
+           (uint32_t)src[2] << 0x08 |
+           (uint32_t)src[3] << 0x00;
+#endif
+}
+
+// When the whole build targets SSE4.1 (or AVX2), expand the message
+// schedule four words at a time instead of one — the rounds below stay
+// scalar and consume words while later ones are still being computed
+#if defined(__x86_64__) && defined(__SSE4_1__) && SHA256_KERNEL_SCALAR
+    #define SHA256_SCHEDULE_SSE 1
+
+// σ0 and σ1 across four schedule words at once
+static inline __m128i sig0_x4(__m128i x)
+{
+    const __m128i r07 = _mm_or_si128(_mm_srli_epi32(x, 0x07), _mm_slli_epi32(x, 0x19));
+    const __m128i r12 = _mm_or_si128(_mm_srli_epi32(x, 0x12), _mm_slli_epi32(x, 0x0e));
+    return _mm_xor_si128(_mm_xor_si128(r07, r12), _mm_srli_epi32(x, 0x03));
+}
+
+static inline __m128i sig1_x4(__m128i x)
+{
+    const __m128i r11 = _mm_or_si128(_mm_srli_epi32(x, 0x11), _mm_slli_epi32(x, 0x0f));
+    const __m128i r13 = _mm_or_si128(_mm_srli_epi32(x, 0x13), _mm_slli_epi32(x, 0x0d));
+    return _mm_xor_si128(_mm_xor_si128(r11, r13), _mm_srli_epi32(x, 0x0a));
+}
+
+// Next four schedule words from the previous sixteen (w0..w3 hold
+// w[t-16..t-13] .. w[t-4..t-1]). The σ1 inputs for the upper two lanes
+// depend on the lower two results, so σ1 runs in two halves.
+static inline __m128i sha256_schedule_x4(__m128i w0, __m128i w1, __m128i w2, __m128i w3)
+{
+    __m128i pre = _mm_add_epi32(w0, _mm_alignr_epi8(w3, w2, 4));        // w[t-16] + w[t-7]
+    pre = _mm_add_epi32(pre, sig0_x4(_mm_alignr_epi8(w1, w0, 4)));      // + σ0(w[t-15])
+
+    const __m128i in01 = _mm_shuffle_epi32(w3, _MM_SHUFFLE(1, 0, 3, 2)); // w[t-2], w[t-1] in lanes 0,1
+    const __m128i lo = _mm_add_epi32(pre, sig1_x4(in01));
+
+    const __m128i in23 = _mm_shuffle_epi32(lo, _MM_SHUFFLE(1, 0, 1, 0)); // w[t], w[t+1] in lanes 2,3
+    const __m128i hi = _mm_add_epi32(pre, sig1_x4(in23));
+
+    return _mm_blend_epi16(lo, hi, 0xf0);
+}
+
+static void sha256_schedule_sse(uint32_t w[64], const uint8_t *data)
+{
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bll, 0x0405060700010203ll);
+    __m128i w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&data[0]), mask);
+    __m128i w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&data[16]), mask);
+    __m128i w2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&data[32]), mask);
+    __m128i w3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&data[48]), mask);
+
+    _mm_storeu_si128((__m128i *)&w[0], w0);
+    _mm_storeu_si128((__m128i *)&w[4], w1);
+    _mm_storeu_si128((__m128i *)&w[8], w2);
+    _mm_storeu_si128((__m128i *)&w[12], w3);
+
+    for (size_t i = 16; i < 64; i += 4) {
+        const __m128i wn = sha256_schedule_x4(w0, w1, w2, w3);
+        _mm_storeu_si128((__m128i *)&w[i], wn);
+        w0 = w1;
+        w1 = w2;
+        w2 = w3;
+        w3 = wn;
+    }
+}
+#endif
+
+#if SHA256_KERNEL_SCALAR
+// Portable compression function, one or more 512-bit blocks per call
+static void sha256_compress_scalar(uint32_t *state, const uint8_t *data, size_t nblocks)
+{
+    for (; nblocks; nblocks--, data += 64) {
+        // Message schedule (6.2.2.1)
+        uint32_t w[64];
+#if SHA256_SCHEDULE_SSE
+        sha256_schedule_sse(w, data);
+#else
+        for (size_t i = 0; i < 64; i++) {
+            if (i < 16) {
+                w[i] = sha256_load_be32(&data[4 * i]);
+            }
+            else {
+                w[i] = sig1(w[i - 0x02]) +
+                       sig0(w[i - 0x0f]) +
+                       w[i - 0x07] +
+                       w[i - 0x10];
+            }
+        }
+#endif
+
+        // (6.2.2.2)
+        uint32_t a = state[0];
+        uint32_t b = state[1];
+        uint32_t c = state[2];
+        uint32_t d = state[3];
+        uint32_t e = state[4];
+        uint32_t f = state[5];
+        uint32_t g = state[6];
+        uint32_t h = state[7];
+
+        // Eight rounds per iteration puts the variables back in their
+        // starting slots, so a..h live in registers the whole block
+        for (size_t i = 0; i < 64; i += 8) {
+            SHA256_ROUND(w, a, b, c, d, e, f, g, h, i + 0);
+            SHA256_ROUND(w, h, a, b, c, d, e, f, g, i + 1);
+            SHA256_ROUND(w, g, h, a, b, c, d, e, f, i + 2);
+            SHA256_ROUND(w, f, g, h, a, b, c, d, e, i + 3);
+            SHA256_ROUND(w, e, f, g, h, a, b, c, d, i + 4);
+            SHA256_ROUND(w, d, e, f, g, h, a, b, c, i + 5);
+            SHA256_ROUND(w, c, d, e, f, g, h, a, b, i + 6);
+            SHA256_ROUND(w, b, c, d, e, f, g, h, a, i + 7);
+        }
+
+        // (6.2.2.4)
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+#endif
+
+#if SHA256_KERNEL_SHANI
+// x86 SHA extensions: two rounds per sha256rnds2, schedule updates via
+// sha256msg1/sha256msg2, state held in the ABEF/CDGH register split the
+// instructions expect
+__attribute__((target("sha,sse4.1")))
+static void sha256_compress_shani(uint32_t *state, const uint8_t *data, size_t nblocks)
+{
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bll, 0x0405060700010203ll);
+
+    __m128i tmp = _mm_loadu_si128((const __m128i *)&state[0]);
+    __m128i s1 = _mm_loadu_si128((const __m128i *)&state[4]);
+
+    tmp = _mm_shuffle_epi32(tmp, 0xb1); // CDAB
+    s1 = _mm_shuffle_epi32(s1, 0x1b);   // EFGH
+    __m128i s0 = _mm_alignr_epi8(tmp, s1, 8);  // ABEF
+    s1 = _mm_blend_epi16(s1, tmp, 0xf0);       // CDGH
+
+    for (; nblocks; nblocks--, data += 64) {
+        const __m128i save0 = s0;
+        const __m128i save1 = s1;
+
+        __m128i msg;
+        __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&data[0]), mask);
+        __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&data[16]), mask);
+        __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&data[32]), mask);
+        __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&data[48]), mask);
+
+        // Rounds 0-3
+        msg = _mm_add_epi32(m0, _mm_loadu_si128((const __m128i *)&k[0]));
+        s1 = _mm_sha256rnds2_epu32(s1, s0, msg);
+        s0 = _mm_sha256rnds2_epu32(s0, s1, _mm_shuffle_epi32(msg, 0x0e));
+
+        // Rounds 4-7
+        msg = _mm_add_epi32(m1, _mm_loadu_si128((const __m128i *)&k[4]));
+        s1 = _mm_sha256rnds2_epu32(s1, s0, msg);
+        s0 = _mm_sha256rnds2_epu32(s0, s1, _mm_shuffle_epi32(msg, 0x0e));
+        m0 = _mm_sha256msg1_epu32(m0, m1);
+
+        // Rounds 8-11
+        msg = _mm_add_epi32(m2, _mm_loadu_si128((const __m128i *)&k[8]));
+        s1 = _mm_sha256rnds2_epu32(s1, s0, msg);
+        s0 = _mm_sha256rnds2_epu32(s0, s1, _mm_shuffle_epi32(msg, 0x0e));
+        m1 = _mm_sha256msg1_epu32(m1, m2);
+
+        // Rounds 12-59 follow the same four-round pattern
+        for (size_t i = 12; i < 60; i += 4) {
+            msg = _mm_add_epi32(m3, _mm_loadu_si128((const __m128i *)&k[i]));
+            s1 = _mm_sha256rnds2_epu32(s1, s0, msg);
+            m0 = _mm_sha256msg2_epu32(_mm_add_epi32(m0, _mm_alignr_epi8(m3, m2, 4)), m3);
+            s0 = _mm_sha256rnds2_epu32(s0, s1, _mm_shuffle_epi32(msg, 0x0e));
+            m2 = _mm_sha256msg1_epu32(m2, m3);
+
+            const __m128i rot = m0;
+            m0 = m1;
+            m1 = m2;
+            m2 = m3;
+            m3 = rot;
+        }
+
+        // Rounds 60-63
+        msg = _mm_add_epi32(m3, _mm_loadu_si128((const __m128i *)&k[60]));
+        s1 = _mm_sha256rnds2_epu32(s1, s0, msg);
+        s0 = _mm_sha256rnds2_epu32(s0, s1, _mm_shuffle_epi32(msg, 0x0e));
+
+        s0 = _mm_add_epi32(s0, save0);
+        s1 = _mm_add_epi32(s1, save1);
+    }
+
+    tmp = _mm_shuffle_epi32(s0, 0x1b); // FEBA
+    s1 = _mm_shuffle_epi32(s1, 0xb1);  // DCHG
+    s0 = _mm_blend_epi16(tmp, s1, 0xf0);     // DCBA
+    s1 = _mm_alignr_epi8(s1, tmp, 8);        // HGFE
+
+    _mm_storeu_si128((__m128i *)&state[0], s0);
+    _mm_storeu_si128((__m128i *)&state[4], s1);
+}
 
-    // Message schedule (6.2.2.1)
-    uint32_t w[64];
+#if !SHA256_BACKEND_PINNED
+static int sha256_have_shani(void)
+{
+    uint32_t eax = 0;
+    uint32_t ebx = 0;
+    uint32_t ecx = 0;
+    uint32_t edx = 0;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    if (!(ebx & (1u << 29))) { // SHA
+        return 0;
+    }
+    __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+    return (ecx & (1u << 19)) != 0; // SSE4.1
+}
+#endif
+#endif
+
+#if SHA256_KERNEL_ARMV8
+// ARMv8 crypto extensions: four rounds per vsha256hq/vsha256h2q pair,
+// schedule updates via vsha256su0/vsha256su1
+#if defined(__clang__)
+__attribute__((target("crypto")))
+#else
+__attribute__((target("arch=armv8-a+crypto")))
+#endif
+static void sha256_compress_armv8(uint32_t *state, const uint8_t *data, size_t nblocks)
+{
+    uint32x4_t s0 = vld1q_u32(&state[0]);
+    uint32x4_t s1 = vld1q_u32(&state[4]);
+
+    for (; nblocks; nblocks--, data += 64) {
+        const uint32x4_t save0 = s0;
+        const uint32x4_t save1 = s1;
+
+        uint32x4_t m0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(&data[0])));
+        uint32x4_t m1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(&data[16])));
+        uint32x4_t m2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(&data[32])));
+        uint32x4_t m3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(&data[48])));
+
+        uint32x4_t wk = vaddq_u32(m0, vld1q_u32(&k[0]));
+        for (size_t i = 0; i < 64; i += 4) {
+            const uint32x4_t wk0 = wk;
+            const uint32x4_t e0 = s0;
+
+            if (i + 4 < 64) {
+                wk = vaddq_u32(m1, vld1q_u32(&k[i + 4]));
+            }
+            if (i < 48) {
+                m0 = vsha256su1q_u32(vsha256su0q_u32(m0, m1), m2, m3);
+            }
+            s0 = vsha256hq_u32(s0, s1, wk0);
+            s1 = vsha256h2q_u32(s1, e0, wk0);
+
+            const uint32x4_t rot = m0;
+            m0 = m1;
+            m1 = m2;
+            m2 = m3;
+            m3 = rot;
+        }
+
+        s0 = vaddq_u32(s0, save0);
+        s1 = vaddq_u32(s1, save1);
+    }
+
+    vst1q_u32(&state[0], s0);
+    vst1q_u32(&state[4], s1);
+}
+
+#if !SHA256_BACKEND_PINNED
+static int sha256_have_armv8(void)
+{
+    return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0;
+}
+#endif
+#endif
+
+typedef void (*sha256_compress_fn)(uint32_t *state, const uint8_t *data, size_t nblocks);
+
+#if SHA256_BACKEND_PINNED
+// Pinned build: sha256_compress is a direct call to the one compiled-in
+// kernel — no detection, no indirection, minimum code size
+#if defined(SHA256_BACKEND_SHANI)
+    #define sha256_compress sha256_compress_shani
+#elif defined(SHA256_BACKEND_ARMV8)
+    #define sha256_compress sha256_compress_armv8
+#else
+    #define sha256_compress sha256_compress_scalar
+#endif
+
+const char *sha256_backend(void)
+{
+#if defined(SHA256_BACKEND_SHANI)
+    return "sha-ni";
+#elif defined(SHA256_BACKEND_ARMV8)
+    return "armv8-crypto";
+#else
+    return "scalar";
+#endif
+}
+#else
+static void sha256_compress_resolve(uint32_t *state, const uint8_t *data, size_t nblocks);
+
+// Resolved to the fastest backend this CPU supports on first use
+static sha256_compress_fn sha256_compress = sha256_compress_resolve;
+
+static sha256_compress_fn sha256_select_backend(void)
+{
+#if SHA256_KERNEL_SHANI
+    if (sha256_have_shani()) {
+        return sha256_compress_shani;
+    }
+#endif
+#if SHA256_KERNEL_ARMV8
+    if (sha256_have_armv8()) {
+        return sha256_compress_armv8;
+    }
+#endif
+    return sha256_compress_scalar;
+}
+
+static void sha256_compress_resolve(uint32_t *state, const uint8_t *data, size_t nblocks)
+{
+    sha256_compress = sha256_select_backend();
+    sha256_compress(state, data, nblocks);
+}
+
+const char *sha256_backend(void)
+{
+    const sha256_compress_fn fn = sha256_select_backend();
+#if SHA256_KERNEL_SHANI
+    if (fn == sha256_compress_shani) {
+        return "sha-ni";
+    }
+#endif
+#if SHA256_KERNEL_ARMV8
+    if (fn == sha256_compress_armv8) {
+        return "armv8-crypto";
+    }
+#endif
+    (void)fn;
+    return "scalar";
+}
+#endif
+
+void sha256_hash2(sha256_t *ctx_a, const uint8_t *da, sha256_t *ctx_b, const uint8_t *db)
+{
+    // Both message schedules up front (6.2.2.1), interleaved per word
+    uint32_t wa[64];
+    uint32_t wb[64];
     for (size_t i = 0; i < 64; i++) {
         if (i < 16) {
-            w[i] = (uint32_t)data[4 * i + 0] << 0x18 |
-                   (uint32_t)data[4 * i + 1] << 0x10 |
-                   (uint32_t)data[4 * i + 2] << 0x08 |
-                   (uint32_t)data[4 * i + 3] << 0x00;
+            wa[i] = sha256_load_be32(&da[4 * i]);
+            wb[i] = sha256_load_be32(&db[4 * i]);
         }
         else {
-            w[i] = sig1(w[i - 0x02]) +
-                   sig0(w[i - 0x0f]) +
-                   w[i - 0x07] +
-                   w[i - 0x10];
-        }
-    }
-
-    // (6.2.2.2)
-    uint32_t s[8] = {
-        ctx->state[0], // a
-        ctx->state[1], // b
-        ctx->state[2], // c
-        ctx->state[3], // d
-        ctx->state[4], // e
-        ctx->state[5], // f
-        ctx->state[6], // g
-        ctx->state[7], // h
-    };
+            wa[i] = sig1(wa[i - 0x02]) + sig0(wa[i - 0x0f]) + wa[i - 0x07] + wa[i - 0x10];
+            wb[i] = sig1(wb[i - 0x02]) + sig0(wb[i - 0x0f]) + wb[i - 0x07] + wb[i - 0x10];
+        }
+    }
 
-    // Offsets for indexing into `s` in a way the resembles the spec
-    // Elements are initialized to their index + 1 and get decremented prior computation
-    enum vars {
-        a, b, c, d, e, f, g, h
-    };
-    int32_t idx[] = {
-        [a] = 1, [b] = 2, [c] = 3, [d] = 4, [e] = 5, [f] = 6, [g] = 7, [h] = 8
-    };
+    uint32_t a0 = ctx_a->state[0], a1 = ctx_b->state[0];
+    uint32_t b0 = ctx_a->state[1], b1 = ctx_b->state[1];
+    uint32_t c0 = ctx_a->state[2], c1 = ctx_b->state[2];
+    uint32_t d0 = ctx_a->state[3], d1 = ctx_b->state[3];
+    uint32_t e0 = ctx_a->state[4], e1 = ctx_b->state[4];
+    uint32_t f0 = ctx_a->state[5], f1 = ctx_b->state[5];
+    uint32_t g0 = ctx_a->state[6], g1 = ctx_b->state[6];
+    uint32_t h0 = ctx_a->state[7], h1 = ctx_b->state[7];
 
-    // pragma gcc pls unroll
-    for (size_t i = 0; i < 64; i++) {
+    // Alternate rounds of the two blocks: each stream's serial chain hides
+    // behind the other's independent work
+    for (size_t i = 0; i < 64; i += 8) {
+        SHA256_ROUND(wa, a0, b0, c0, d0, e0, f0, g0, h0, i + 0);
+        SHA256_ROUND(wb, a1, b1, c1, d1, e1, f1, g1, h1, i + 0);
+        SHA256_ROUND(wa, h0, a0, b0, c0, d0, e0, f0, g0, i + 1);
+        SHA256_ROUND(wb, h1, a1, b1, c1, d1, e1, f1, g1, i + 1);
+        SHA256_ROUND(wa, g0, h0, a0, b0, c0, d0, e0, f0, i + 2);
+        SHA256_ROUND(wb, g1, h1, a1, b1, c1, d1, e1, f1, i + 2);
+        SHA256_ROUND(wa, f0, g0, h0, a0, b0, c0, d0, e0, i + 3);
+        SHA256_ROUND(wb, f1, g1, h1, a1, b1, c1, d1, e1, i + 3);
+        SHA256_ROUND(wa, e0, f0, g0, h0, a0, b0, c0, d0, i + 4);
+        SHA256_ROUND(wb, e1, f1, g1, h1, a1, b1, c1, d1, i + 4);
+        SHA256_ROUND(wa, d0, e0, f0, g0, h0, a0, b0, c0, i + 5);
+        SHA256_ROUND(wb, d1, e1, f1, g1, h1, a1, b1, c1, i + 5);
+        SHA256_ROUND(wa, c0, d0, e0, f0, g0, h0, a0, b0, i + 6);
+        SHA256_ROUND(wb, c1, d1, e1, f1, g1, h1, a1, b1, i + 6);
+        SHA256_ROUND(wa, b0, c0, d0, e0, f0, g0, h0, a0, i + 7);
+        SHA256_ROUND(wb, b1, c1, d1, e1, f1, g1, h1, a1, i + 7);
+    }
+
+    ctx_a->state[0] += a0;
+    ctx_a->state[1] += b0;
+    ctx_a->state[2] += c0;
+    ctx_a->state[3] += d0;
+    ctx_a->state[4] += e0;
+    ctx_a->state[5] += f0;
+    ctx_a->state[6] += g0;
+    ctx_a->state[7] += h0;
+    ctx_a->bits_total += 512;
+
+    ctx_b->state[0] += a1;
+    ctx_b->state[1] += b1;
+    ctx_b->state[2] += c1;
+    ctx_b->state[3] += d1;
+    ctx_b->state[4] += e1;
+    ctx_b->state[5] += f1;
+    ctx_b->state[6] += g1;
+    ctx_b->state[7] += h1;
+    ctx_b->bits_total += 512;
+}
+
+// Serialize state words big-endian into the destination
+static void sha256_output(const uint32_t *state, uint8_t *hash)
+{
+    for (size_t i = 0; i < 4; i++) {
         for (size_t j = 0; j < 8; j++) {
-            idx[j] = idx[j] ? idx[j] - 1 : 7;
-        }
-        // (6.2.2.3)
-        s[idx[h]] += sum1(s[idx[e]]);
-        s[idx[h]] += ch(s[idx[e]], s[idx[f]], s[idx[g]]);
-        s[idx[h]] += k[i];
-        s[idx[h]] += w[i];
-        s[idx[d]] += s[idx[h]];
-        s[idx[h]] += maj(s[idx[a]], s[idx[b]], s[idx[c]]);
-        s[idx[h]] += sum0(s[idx[a]]);
-    }
-    // (6.2.2.4)
-    for (size_t i = 0; i < 8; i++) {
-        ctx->state[i] += s[i];
+            hash[(4 * j) + i] = (state[j] >> (24 - (8 * i))) & 0xff;
+        }
+    }
+}
+
+// Opt-in per-context accounting; every macro below compiles to nothing
+// unless the whole build defines SHA256_STATS
+#ifdef SHA256_STATS
+static void sha256_stat_blocks(sha256_t *ctx, uint64_t nblocks)
+{
+    ctx->stat_blocks += nblocks;
+    if (ctx->sample_every) {
+        while (ctx->stat_blocks >= ctx->sample_next) {
+            ctx->sample_fn(ctx->stat_blocks, ctx->sample_arg);
+            ctx->sample_next += ctx->sample_every;
+        }
     }
 }
 
+void sha256_stats(const sha256_t *ctx, sha256_stats_t *out)
+{
+    out->blocks = ctx->stat_blocks;
+    out->bulk_bytes = ctx->stat_bulk_bytes;
+    out->buffered_bytes = ctx->stat_buffered_bytes;
+    out->backend = sha256_backend();
+}
+
+void sha256_sample(sha256_t *ctx, uint64_t every, sha256_sample_fn fn, void *arg)
+{
+    ctx->sample_every = fn ? every : 0;
+    ctx->sample_next = ctx->stat_blocks + every;
+    ctx->sample_fn = fn;
+    ctx->sample_arg = arg;
+}
+
+    #define SHA256_STAT_BLOCKS(ctx, n) sha256_stat_blocks(ctx, n)
+    #define SHA256_STAT_BULK(ctx, n) ((ctx)->stat_bulk_bytes += (n))
+    #define SHA256_STAT_BUFFERED(ctx, n) ((ctx)->stat_buffered_bytes += (n))
+#else
+    #define SHA256_STAT_BLOCKS(ctx, n) ((void)0)
+    #define SHA256_STAT_BULK(ctx, n) ((void)0)
+    #define SHA256_STAT_BUFFERED(ctx, n) ((void)0)
+#endif
+
 void sha256_append(sha256_t *ctx, const void *src, size_t len)
 {
     const uint8_t *data = (const uint8_t *)src;
-    for (size_t i = 0; i < len; i++) {
-        // Copy byte over to the context block and hash
-        // in 512-bit increments
-        ctx->data[ctx->block_bytes++] = data[i];
+
+    // Top off a partially-filled context block and hash it once full
+    if (ctx->block_bytes) {
+        const size_t remaining = 64 - ctx->block_bytes;
+        const size_t head = len < remaining ? len : remaining;
+        memcpy(&ctx->data[ctx->block_bytes], data, head);
+        ctx->block_bytes += head;
+        data += head;
+        len -= head;
+        SHA256_STAT_BUFFERED(ctx, head);
         if (ctx->block_bytes == 64) {
-            sha256_hash(ctx, ctx->data);
+            sha256_compress(ctx->state, ctx->data, 1);
             ctx->bits_total += 512;
             ctx->block_bytes = 0;
+            SHA256_STAT_BLOCKS(ctx, 1);
         }
     }
+
+    // Hash full 512-bit blocks straight out of the caller's buffer
+    if (len >= 64) {
+        const size_t nblocks = len / 64;
+        sha256_compress(ctx->state, data, nblocks);
+        ctx->bits_total += 512 * nblocks;
+        data += 64 * nblocks;
+        len -= 64 * nblocks;
+        SHA256_STAT_BLOCKS(ctx, nblocks);
+        SHA256_STAT_BULK(ctx, 64 * nblocks);
+    }
+
+    // Stage whatever's left for the next append or finish
+    if (len) {
+        memcpy(ctx->data, data, len);
+        ctx->block_bytes = len;
+        SHA256_STAT_BUFFERED(ctx, len);
+    }
 }
 
-void sha256_finish(sha256_t *ctx, void *dst)
+// Buffers at least this large take the prefetching path
+#ifndef SHA256_STREAM_THRESHOLD
+    #define SHA256_STREAM_THRESHOLD (256 * 1024)
+#endif
+
+// How far ahead of the compression loop to prefetch, in 64-byte blocks
+#ifndef SHA256_STREAM_LOOKAHEAD
+    #define SHA256_STREAM_LOOKAHEAD 8
+#endif
+
+void sha256_append_stream(sha256_t *ctx, const void *src, size_t len)
+{
+    if (len < SHA256_STREAM_THRESHOLD) {
+        sha256_append(ctx, src, len);
+        return;
+    }
+
+    const uint8_t *data = (const uint8_t *)src;
+
+    // Let the buffered path square up to a block boundary
+    if (ctx->block_bytes) {
+        const size_t head = 64 - ctx->block_bytes;
+        sha256_append(ctx, data, head);
+        data += head;
+        len -= head;
+    }
+
+    // Walk the bulk in lookahead-sized strides, prefetching the next
+    // stride with non-temporal hint so the lines bypass the cache
+    // hierarchy on the way out
+    size_t nblocks = len / 64;
+    while (nblocks >= SHA256_STREAM_LOOKAHEAD) {
+#if defined(__GNUC__)
+        for (size_t i = 0; i < SHA256_STREAM_LOOKAHEAD; i++) {
+            __builtin_prefetch(&data[64 * (SHA256_STREAM_LOOKAHEAD + i)], 0, 0);
+        }
+#endif
+        sha256_compress(ctx->state, data, SHA256_STREAM_LOOKAHEAD);
+        ctx->bits_total += 512 * SHA256_STREAM_LOOKAHEAD;
+        SHA256_STAT_BLOCKS(ctx, SHA256_STREAM_LOOKAHEAD);
+        SHA256_STAT_BULK(ctx, 64 * SHA256_STREAM_LOOKAHEAD);
+        data += 64 * SHA256_STREAM_LOOKAHEAD;
+        nblocks -= SHA256_STREAM_LOOKAHEAD;
+        len -= 64 * SHA256_STREAM_LOOKAHEAD;
+    }
+
+    // Remaining blocks and tail fragment take the normal path
+    sha256_append(ctx, data, len);
+}
+
+size_t sha256_append_budget(sha256_t *ctx, const void *src, size_t len, size_t max_bytes, size_t *consumed)
+{
+    // Bound the work done this call; the staged-block logic in
+    // sha256_append keeps any split point valid, so the caller can
+    // resume from src + taken whenever it next gets scheduled
+    const size_t taken = len < max_bytes ? len : max_bytes;
+    if (taken) {
+        sha256_append(ctx, src, taken);
+    }
+    if (consumed) {
+        *consumed = taken;
+    }
+    return len - taken;
+}
+
+#if SHA256_POSIX
+void sha256_appendv(sha256_t *ctx, const struct iovec *iov, size_t iovcnt)
+{
+    // Each fragment's full blocks hash in place; only a fragment ending
+    // mid-block passes through ctx->data, where the next fragment's head
+    // tops it off
+    for (size_t i = 0; i < iovcnt; i++) {
+        if (iov[i].iov_len) {
+            sha256_append(ctx, iov[i].iov_base, iov[i].iov_len);
+        }
+    }
+}
+#endif
+
+// Padding and final compressions (5.1.1), shared with the SHA-224 finish
+static void sha256_pad(sha256_t *ctx)
 {
-    uint8_t *hash = (uint8_t *)dst;
     uint32_t block = ctx->block_bytes;
 
     ctx->data[block++] = 128;
@@ -174,8 +780,9 @@ void sha256_finish(sha256_t *ctx, void *dst)
         ctx->data[block++] = 0;
     }
     if (end == 64) {
-        sha256_hash(ctx, ctx->data);
+        sha256_compress(ctx->state, ctx->data, 1);
         memset(ctx->data, 0, 64);
+        SHA256_STAT_BLOCKS(ctx, 1);
     }
 
     // Add total length to the last 8 bytes
@@ -183,12 +790,1451 @@ void sha256_finish(sha256_t *ctx, void *dst)
     for (size_t i = 0; i < 8; i++) {
         ctx->data[63 - i] = (uint8_t)(ctx->bits_total >> (uint8_t)(8 * i));
     }
-    sha256_hash(ctx, ctx->data);
+    sha256_compress(ctx->state, ctx->data, 1);
+    SHA256_STAT_BLOCKS(ctx, 1);
+}
+
+void sha256_finish(sha256_t *ctx, void *dst)
+{
+    sha256_pad(ctx);
 
     // Copy into destination in reverse order
+    sha256_output(ctx->state, (uint8_t *)dst);
+}
+
+int sha256_verify(sha256_t *ctx, const uint8_t expected[32])
+{
+    sha256_pad(ctx);
+
+    // Fold the expected bytes into words and accumulate every difference
+    // before the single branch at the end — no early exit, no output buffer
+    uint32_t diff = 0;
+    for (size_t i = 0; i < 8; i++) {
+        diff |= ctx->state[i] ^ sha256_load_be32(&expected[4 * i]);
+    }
+    return diff == 0;
+}
+
+// (5.3.1)
+static const uint32_t sha224_iv[8] = {
+    0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
+    0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4
+};
+
+void sha224_init(sha256_t *ctx)
+{
+    memset(ctx, 0, sizeof(sha256_t));
+    memcpy(ctx->state, sha224_iv, sizeof(sha224_iv));
+}
+
+void sha224_finish(sha256_t *ctx, void *dst)
+{
+    sha256_pad(ctx);
+
+    // SHA-224 keeps the leftmost seven state words (6.3)
+    uint8_t *hash = (uint8_t *)dst;
     for (size_t i = 0; i < 4; i++) {
-        for (size_t j = 0; j < 8; j++) {
+        for (size_t j = 0; j < 7; j++) {
             hash[(4 * j) + i] = (ctx->state[j] >> (24 - (8 * i))) & 0xff;
         }
     }
 }
+
+void sha224(const void *src, size_t len, void *dst)
+{
+    sha256_t ctx;
+    sha224_init(&ctx);
+    sha256_append(&ctx, src, len);
+    sha224_finish(&ctx, dst);
+}
+
+void sha256d(const void *src, size_t len, void *dst)
+{
+    // Inner digest straight into a pre-padded outer block: 32 digest
+    // bytes, 0x80, zeros, and a constant 256-bit length field
+    uint8_t block[64] = { 0 };
+    sha256(src, len, block);
+    block[32] = 128;
+    block[62] = 0x01; // 8 * 32 = 0x100 bits
+
+    uint32_t state[8];
+    memcpy(state, sha256_iv, sizeof(sha256_iv));
+    sha256_compress(state, block, 1);
+    sha256_output(state, (uint8_t *)dst);
+}
+
+#ifndef SHA256_BACKEND_SCALAR
+// Padding block for a message of exactly 64 bytes — fully constant
+static const uint8_t sha256_pad64[64] = {
+    [0] = 128, [62] = 0x02 // 0x0200 = 512 message bits
+};
+#endif
+
+#if SHA256_KERNEL_SCALAR
+// Message schedule of that padding block, expanded at table-generation
+// time with k[i] already added — the scalar finish below runs rounds
+// only, no schedule and no padding construction
+static const uint32_t sha256_block64_wk[64] = {
+    0xc28a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf374,
+    0x649b69c1, 0xf0fe4786, 0x0fe1edc6, 0x240cf254, 0x4fe9346f, 0x6cc984be, 0x61b9411e, 0x16f988fa,
+    0xf2c65152, 0xa88e5a6d, 0xb019fc65, 0xb9d99ec7, 0x9a1231c3, 0xe70eeaa0, 0xfdb1232b, 0xc7353eb0,
+    0x3069bad5, 0xcb976d5f, 0x5a0f118f, 0xdc1eeefd, 0x0a35b689, 0xde0b7a04, 0x58f4ca9d, 0xe15d5b16,
+    0x007f3e86, 0x37088980, 0xa507ea32, 0x6fab9537, 0x17406110, 0x0d8cd6f1, 0xcdaa3b6d, 0xc0bbbe37,
+    0x83613bda, 0xdb48a363, 0x0b02e931, 0x6fd15ca7, 0x521afaca, 0x31338431, 0x6ed41a95, 0x6d437890,
+    0xc39c91f2, 0x9eccabbd, 0xb5c9a0e6, 0x532fb63c, 0xd2c741c6, 0x07237ea3, 0xa4954b68, 0x4c191d76
+};
+
+// Constant-schedule finishing block (6.2.2.2) - (6.2.2.4)
+static void sha256_block64_finish(uint32_t *state, uint8_t *dst)
+{
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+    uint32_t e = state[4];
+    uint32_t f = state[5];
+    uint32_t g = state[6];
+    uint32_t h = state[7];
+
+    for (size_t i = 0; i < 64; i += 8) {
+        SHA256_ROUND_WK(sha256_block64_wk, a, b, c, d, e, f, g, h, i + 0);
+        SHA256_ROUND_WK(sha256_block64_wk, h, a, b, c, d, e, f, g, i + 1);
+        SHA256_ROUND_WK(sha256_block64_wk, g, h, a, b, c, d, e, f, i + 2);
+        SHA256_ROUND_WK(sha256_block64_wk, f, g, h, a, b, c, d, e, i + 3);
+        SHA256_ROUND_WK(sha256_block64_wk, e, f, g, h, a, b, c, d, i + 4);
+        SHA256_ROUND_WK(sha256_block64_wk, d, e, f, g, h, a, b, c, i + 5);
+        SHA256_ROUND_WK(sha256_block64_wk, c, d, e, f, g, h, a, b, i + 6);
+        SHA256_ROUND_WK(sha256_block64_wk, b, c, d, e, f, g, h, a, i + 7);
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+    sha256_output(state, dst);
+}
+#endif
+
+void sha256_block64(const uint8_t src[64], uint8_t dst[32])
+{
+    uint32_t state[8];
+    memcpy(state, sha256_iv, sizeof(sha256_iv));
+    sha256_compress(state, src, 1);
+
+    // The precomputed schedule only beats the scalar rounds it replaces;
+    // a hardware backend chews through the constant block faster than
+    // the scalar finish would, so it just compresses it like any other
+#if defined(SHA256_BACKEND_SCALAR)
+    sha256_block64_finish(state, dst);
+#elif SHA256_BACKEND_PINNED
+    sha256_compress(state, sha256_pad64, 1);
+    sha256_output(state, dst);
+#else
+    if (sha256_compress == sha256_compress_scalar) {
+        sha256_block64_finish(state, dst);
+    }
+    else {
+        sha256_compress(state, sha256_pad64, 1);
+        sha256_output(state, dst);
+    }
+#endif
+}
+
+void sha256_clone(const sha256_t *src, sha256_t *dst)
+{
+    memcpy(dst, src, sizeof(sha256_t));
+}
+
+void sha256_save(const sha256_t *ctx, sha256_midstate_t *mid)
+{
+    memcpy(mid->state, ctx->state, sizeof(mid->state));
+    mid->bits_total = ctx->bits_total;
+}
+
+void sha256_restore(sha256_t *ctx, const sha256_midstate_t *mid)
+{
+    memcpy(ctx->state, mid->state, sizeof(mid->state));
+    ctx->bits_total = mid->bits_total;
+    ctx->block_bytes = 0;
+}
+
+void sha256_export(const sha256_t *ctx, uint8_t out[SHA256_EXPORT_SIZE])
+{
+    for (size_t i = 0; i < 8; i++) {
+        out[4 * i + 0] = (uint8_t)(ctx->state[i] >> 0x00);
+        out[4 * i + 1] = (uint8_t)(ctx->state[i] >> 0x08);
+        out[4 * i + 2] = (uint8_t)(ctx->state[i] >> 0x10);
+        out[4 * i + 3] = (uint8_t)(ctx->state[i] >> 0x18);
+    }
+    for (size_t i = 0; i < 8; i++) {
+        out[32 + i] = (uint8_t)(ctx->bits_total >> (8 * i));
+    }
+    out[40] = (uint8_t)ctx->block_bytes;
+    memset(&out[41], 0, 63);
+    memcpy(&out[41], ctx->data, ctx->block_bytes);
+}
+
+int sha256_import(sha256_t *ctx, const uint8_t in[SHA256_EXPORT_SIZE])
+{
+    if (in[40] > 63) {
+        return -1;
+    }
+    memset(ctx, 0, sizeof(sha256_t));
+    for (size_t i = 0; i < 8; i++) {
+        ctx->state[i] = (uint32_t)in[4 * i + 0] << 0x00 |
+                        (uint32_t)in[4 * i + 1] << 0x08 |
+                        (uint32_t)in[4 * i + 2] << 0x10 |
+                        (uint32_t)in[4 * i + 3] << 0x18;
+    }
+    for (size_t i = 0; i < 8; i++) {
+        ctx->bits_total |= (uint64_t)in[32 + i] << (8 * i);
+    }
+    ctx->block_bytes = in[40];
+    memcpy(ctx->data, &in[41], ctx->block_bytes);
+    return 0;
+}
+
+void sha256(const void *src, size_t len, void *dst)
+{
+    const uint8_t *data = (const uint8_t *)src;
+
+    uint32_t state[8];
+    memcpy(state, sha256_iv, sizeof(sha256_iv));
+
+    // Bulk of the message straight from the caller's buffer
+    if (len >= 64) {
+        sha256_compress(state, data, len / 64);
+        data += len - (len % 64);
+    }
+
+    // Pad the tail on the stack (5.1.1): 0x80, zeros, length in bits —
+    // only the pad bytes actually used get touched
+    const size_t tail = len % 64;
+    uint8_t pad[128];
+    if (tail) {
+        memcpy(pad, data, tail);
+    }
+    pad[tail] = 128;
+    const size_t end = tail < 56 ? 64 : 128;
+    memset(&pad[tail + 1], 0, end - 8 - (tail + 1));
+    const uint64_t bits = 8 * (uint64_t)len;
+    for (size_t i = 0; i < 8; i++) {
+        pad[end - 1 - i] = (uint8_t)(bits >> (8 * i));
+    }
+    sha256_compress(state, pad, end / 64);
+
+    sha256_output(state, (uint8_t *)dst);
+}
+
+#if SHA256_KERNEL_AVX2
+// One message viewed as a padded block stream: `full` blocks straight from
+// the source followed by one or two pre-built padding blocks (5.1.1)
+typedef struct sha256_lane_t {
+    const uint8_t *src;
+    size_t full;
+    size_t pad_blocks;
+    size_t total;
+    uint8_t pad[128];
+} sha256_lane_t;
+
+static void sha256_lane_init(sha256_lane_t *lane, const void *src, size_t len)
+{
+    lane->src = (const uint8_t *)src;
+    lane->full = len / 64;
+
+    const size_t tail = len % 64;
+    memset(lane->pad, 0, sizeof(lane->pad));
+    if (tail) {
+        memcpy(lane->pad, &lane->src[64 * lane->full], tail);
+    }
+    lane->pad[tail] = 128;
+    lane->pad_blocks = tail < 56 ? 1 : 2;
+    lane->total = lane->full + lane->pad_blocks;
+
+    const uint64_t bits = 8 * (uint64_t)len;
+    uint8_t *end = &lane->pad[64 * lane->pad_blocks];
+    for (size_t i = 0; i < 8; i++) {
+        end[-1 - (ptrdiff_t)i] = (uint8_t)(bits >> (8 * i));
+    }
+}
+
+// Run any blocks past `blk` through the single-stream backend and output
+static void sha256_lane_finish(const sha256_lane_t *lane, uint32_t *state, size_t blk, uint8_t *dst)
+{
+    if (blk < lane->full) {
+        sha256_compress(state, &lane->src[64 * blk], lane->full - blk);
+        blk = lane->full;
+    }
+    if (blk < lane->total) {
+        sha256_compress(state, &lane->pad[64 * (blk - lane->full)], lane->total - blk);
+    }
+    sha256_output(state, dst);
+}
+
+#define SHA256_TARGET_AVX2 __attribute__((target("avx2")))
+
+// The scalar round helpers, eight lanes wide
+
+SHA256_TARGET_AVX2
+static inline __m256i shr_x8(__m256i x, int n)
+{
+    return _mm256_srli_epi32(x, n);
+}
+
+SHA256_TARGET_AVX2
+static inline __m256i rotr_x8(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 0x20 - n));
+}
+
+SHA256_TARGET_AVX2
+static inline __m256i ch_x8(__m256i x, __m256i y, __m256i z)
+{
+    return _mm256_xor_si256(_mm256_and_si256(x, y), _mm256_andnot_si256(x, z));
+}
+
+SHA256_TARGET_AVX2
+static inline __m256i maj_x8(__m256i x, __m256i y, __m256i z)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(_mm256_and_si256(x, y), _mm256_and_si256(x, z)),
+                            _mm256_and_si256(y, z));
+}
+
+SHA256_TARGET_AVX2
+static inline __m256i sum0_x8(__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(rotr_x8(x, 0x02), rotr_x8(x, 0x0d)), rotr_x8(x, 0x16));
+}
+
+SHA256_TARGET_AVX2
+static inline __m256i sum1_x8(__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(rotr_x8(x, 0x06), rotr_x8(x, 0x0b)), rotr_x8(x, 0x19));
+}
+
+SHA256_TARGET_AVX2
+static inline __m256i sig0_x8(__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(rotr_x8(x, 0x07), rotr_x8(x, 0x12)), shr_x8(x, 0x03));
+}
+
+SHA256_TARGET_AVX2
+static inline __m256i sig1_x8(__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(rotr_x8(x, 0x11), rotr_x8(x, 0x13)), shr_x8(x, 0x0a));
+}
+
+// Transpose eight rows of eight 32-bit words into columns
+SHA256_TARGET_AVX2
+static void sha256_transpose_x8(__m256i *out, const __m256i *r)
+{
+    const __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    const __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    const __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+    const __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    const __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+    const __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    const __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+    const __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+    const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+    const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+    const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+    const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+    out[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    out[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    out[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    out[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    out[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    out[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    out[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    out[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+// Load one block per lane, byte-swapped and transposed so w[t] holds
+// word t of all eight lanes
+SHA256_TARGET_AVX2
+static void sha256_load_x8(__m256i w[16], const uint8_t *const blocks[8])
+{
+    const __m256i mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                          3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    __m256i r[16];
+    for (size_t lane = 0; lane < 8; lane++) {
+        r[lane + 0] = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)&blocks[lane][0]), mask);
+        r[lane + 8] = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)&blocks[lane][32]), mask);
+    }
+    sha256_transpose_x8(&w[0], &r[0]);
+    sha256_transpose_x8(&w[8], &r[8]);
+}
+
+// (6.2.2) across eight independent blocks at once
+SHA256_TARGET_AVX2
+static void sha256_compress_x8(__m256i st[8], const uint8_t *const blocks[8])
+{
+    __m256i w[16];
+    sha256_load_x8(w, blocks);
+
+    __m256i a = st[0];
+    __m256i b = st[1];
+    __m256i c = st[2];
+    __m256i d = st[3];
+    __m256i e = st[4];
+    __m256i f = st[5];
+    __m256i g = st[6];
+    __m256i h = st[7];
+
+    for (size_t i = 0; i < 64; i++) {
+        __m256i wi = w[i & 15];
+        if (i >= 16) {
+            wi = _mm256_add_epi32(_mm256_add_epi32(sig1_x8(w[(i - 0x02) & 15]), w[(i - 0x07) & 15]),
+                                  _mm256_add_epi32(sig0_x8(w[(i - 0x0f) & 15]), wi));
+            w[i & 15] = wi;
+        }
+        const __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, sum1_x8(e)),
+                                                             _mm256_add_epi32(ch_x8(e, f, g), wi)),
+                                            _mm256_set1_epi32((int32_t)k[i]));
+        const __m256i t2 = _mm256_add_epi32(sum0_x8(a), maj_x8(a, b, c));
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(t1, t2);
+    }
+
+    st[0] = _mm256_add_epi32(st[0], a);
+    st[1] = _mm256_add_epi32(st[1], b);
+    st[2] = _mm256_add_epi32(st[2], c);
+    st[3] = _mm256_add_epi32(st[3], d);
+    st[4] = _mm256_add_epi32(st[4], e);
+    st[5] = _mm256_add_epi32(st[5], f);
+    st[6] = _mm256_add_epi32(st[6], g);
+    st[7] = _mm256_add_epi32(st[7], h);
+}
+
+// Hash eight messages in lockstep for as long as every lane still has
+// blocks, then finish the longer ones single-stream
+SHA256_TARGET_AVX2
+static void sha256_nway_x8(const void *const *srcs, const size_t *lens, uint8_t (*digests)[32])
+{
+    sha256_lane_t lanes[8];
+    size_t lockstep = (size_t)-1;
+    for (size_t i = 0; i < 8; i++) {
+        sha256_lane_init(&lanes[i], srcs[i], lens[i]);
+        lockstep = lanes[i].total < lockstep ? lanes[i].total : lockstep;
+    }
+
+    __m256i st[8];
+    for (size_t i = 0; i < 8; i++) {
+        st[i] = _mm256_set1_epi32((int32_t)sha256_iv[i]);
+    }
+
+    for (size_t blk = 0; blk < lockstep; blk++) {
+        const uint8_t *blocks[8];
+        for (size_t lane = 0; lane < 8; lane++) {
+            blocks[lane] = blk < lanes[lane].full ? &lanes[lane].src[64 * blk]
+                                                  : &lanes[lane].pad[64 * (blk - lanes[lane].full)];
+        }
+        sha256_compress_x8(st, blocks);
+    }
+
+    uint32_t cols[8][8];
+    for (size_t i = 0; i < 8; i++) {
+        _mm256_storeu_si256((__m256i *)cols[i], st[i]);
+    }
+    for (size_t lane = 0; lane < 8; lane++) {
+        uint32_t state[8];
+        for (size_t i = 0; i < 8; i++) {
+            state[i] = cols[i][lane];
+        }
+        sha256_lane_finish(&lanes[lane], state, lockstep, digests[lane]);
+    }
+}
+
+__attribute__((target("xsave")))
+static int sha256_have_avx2(void)
+{
+    uint32_t eax = 0;
+    uint32_t ebx = 0;
+    uint32_t ecx = 0;
+    uint32_t edx = 0;
+    __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+    if (!(ecx & (1u << 27)) || !(ecx & (1u << 28))) { // OSXSAVE, AVX
+        return 0;
+    }
+    if ((_xgetbv(0) & 0x6) != 0x6) { // XMM and YMM state enabled
+        return 0;
+    }
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    return (ebx & (1u << 5)) != 0; // AVX2
+}
+#endif
+
+void sha256_hash_nway(const void *const *srcs, const size_t *lens, size_t count, uint8_t (*digests)[32])
+{
+#if SHA256_KERNEL_AVX2
+    if (sha256_have_avx2()) {
+        for (; count >= 8; srcs += 8, lens += 8, digests += 8, count -= 8) {
+            sha256_nway_x8(srcs, lens, digests);
+        }
+    }
+#endif
+    for (size_t i = 0; i < count; i++) {
+        sha256_t ctx;
+        sha256_init(&ctx);
+        sha256_append(&ctx, srcs[i], lens[i]);
+        sha256_finish(&ctx, digests[i]);
+    }
+}
+
+#ifndef SHA256_TREE_LEAF_SIZE
+    #define SHA256_TREE_LEAF_SIZE (1024 * 1024)
+#endif
+
+#if SHA256_POSIX
+typedef struct sha256_tree_job_t {
+    const void *const *srcs;
+    const size_t *lens;
+    uint8_t (*digests)[32];
+    size_t lo;
+    size_t hi;
+} sha256_tree_job_t;
+
+static void *sha256_tree_worker(void *arg)
+{
+    sha256_tree_job_t *job = (sha256_tree_job_t *)arg;
+    sha256_hash_nway(&job->srcs[job->lo], &job->lens[job->lo], job->hi - job->lo, &job->digests[job->lo]);
+    return NULL;
+}
+#endif
+
+int sha256_tree(const void *src, size_t len, size_t nthreads, void *dst)
+{
+    const uint8_t *data = (const uint8_t *)src;
+
+    const size_t nleaves = len ? (len + SHA256_TREE_LEAF_SIZE - 1) / SHA256_TREE_LEAF_SIZE : 1;
+    if (nleaves == 1) {
+        sha256(src, len, dst);
+        return 0;
+    }
+
+    const void **srcs = (const void **)calloc(nleaves, sizeof(void *));
+    size_t *lens = (size_t *)calloc(nleaves, sizeof(size_t));
+    uint8_t (*digests)[32] = (uint8_t (*)[32])malloc(32 * nleaves);
+    if (!srcs || !lens || !digests) {
+        free(srcs);
+        free(lens);
+        free(digests);
+        return -1;
+    }
+    for (size_t i = 0; i < nleaves; i++) {
+        srcs[i] = &data[SHA256_TREE_LEAF_SIZE * i];
+        lens[i] = i + 1 < nleaves ? SHA256_TREE_LEAF_SIZE : len - SHA256_TREE_LEAF_SIZE * i;
+    }
+
+#if SHA256_POSIX
+    if (nthreads > nleaves) {
+        nthreads = nleaves;
+    }
+    if (nthreads > 1) {
+        pthread_t *tids = (pthread_t *)malloc(nthreads * sizeof(pthread_t));
+        sha256_tree_job_t *jobs = (sha256_tree_job_t *)malloc(nthreads * sizeof(sha256_tree_job_t));
+        if (!tids || !jobs) {
+            nthreads = 1; // fall through to the serial path
+        }
+        else {
+            for (size_t t = 0; t < nthreads; t++) {
+                jobs[t] = (sha256_tree_job_t) {
+                    .srcs = srcs,
+                    .lens = lens,
+                    .digests = digests,
+                    .lo = nleaves * t / nthreads,
+                    .hi = nleaves * (t + 1) / nthreads,
+                };
+            }
+            // Leave the last slice for the calling thread; any slice whose
+            // worker fails to start just runs here as well
+            size_t spawned = 0;
+            for (size_t t = 0; t + 1 < nthreads; t++) {
+                if (pthread_create(&tids[spawned], NULL, sha256_tree_worker, &jobs[t])) {
+                    sha256_tree_worker(&jobs[t]);
+                    continue;
+                }
+                spawned++;
+            }
+            sha256_tree_worker(&jobs[nthreads - 1]);
+            for (size_t t = 0; t < spawned; t++) {
+                pthread_join(tids[t], NULL);
+            }
+        }
+        free(tids);
+        free(jobs);
+    }
+    if (nthreads <= 1)
+#else
+    (void)nthreads;
+#endif
+    {
+        sha256_hash_nway(srcs, lens, nleaves, digests);
+    }
+
+    // Reduce pairwise up to the root — children are adjacent in the digest
+    // array, so each interior node hashes 64 contiguous bytes through the
+    // fixed-length fast path
+    for (size_t n = nleaves; n > 1; n = (n + 1) / 2) {
+        for (size_t i = 0; 2 * i < n; i++) {
+            if (2 * i + 1 < n) {
+                sha256_block64(digests[2 * i], digests[i]);
+            }
+            else {
+                memcpy(digests[i], digests[2 * i], 32);
+            }
+        }
+    }
+    memcpy(dst, digests[0], 32);
+
+    free(srcs);
+    free(lens);
+    free(digests);
+    return 0;
+}
+
+// SHA256(left || right) without context churn: one dynamic compression
+// plus the constant-schedule finishing block inside sha256_block64
+static void sha256_merkle_node(const uint8_t *left, const uint8_t *right, uint8_t *dst)
+{
+    uint8_t block[64];
+    memcpy(block, left, 32);
+    memcpy(&block[32], right, 32);
+    sha256_block64(block, dst);
+}
+
+// Number of nodes at reduction level k, given the level below
+static size_t sha256_merkle_width(size_t count, size_t level)
+{
+    for (size_t k = 0; k < level; k++) {
+        count = (count + 1) / 2;
+    }
+    return count;
+}
+
+// Value of node (level, index) recomputed from the stored leaves, using
+// the same pair-and-promote rule as sha256_tree
+static void sha256_merkle_node_at(const sha256_merkle_t *tree, size_t level, size_t index, uint8_t *dst)
+{
+    if (level == 0) {
+        memcpy(dst, tree->leaves[index], 32);
+        return;
+    }
+    if (2 * index + 1 < sha256_merkle_width(tree->count, level - 1)) {
+        uint8_t pair[64];
+        sha256_merkle_node_at(tree, level - 1, 2 * index + 0, &pair[0]);
+        sha256_merkle_node_at(tree, level - 1, 2 * index + 1, &pair[32]);
+        sha256_merkle_node(&pair[0], &pair[32], dst);
+    }
+    else {
+        sha256_merkle_node_at(tree, level - 1, 2 * index, dst); // promoted
+    }
+}
+
+void sha256_merkle_init(sha256_merkle_t *tree)
+{
+    memset(tree, 0, sizeof(sha256_merkle_t));
+}
+
+void sha256_merkle_free(sha256_merkle_t *tree)
+{
+    free(tree->leaves);
+    memset(tree, 0, sizeof(sha256_merkle_t));
+}
+
+int sha256_merkle_append(sha256_merkle_t *tree, const uint8_t leaf[32])
+{
+    if (tree->count == tree->cap) {
+        const size_t grown = tree->cap ? 2 * tree->cap : 256;
+        uint8_t (*resized)[32] = (uint8_t (*)[32])realloc(tree->leaves, grown * 32);
+        if (!resized) {
+            return -1;
+        }
+        tree->leaves = resized;
+        tree->cap = grown;
+    }
+    memcpy(tree->leaves[tree->count], leaf, 32);
+
+    // Binary-counter merge: each set bit of count holds the root of a
+    // complete subtree; carrying the new leaf up through the set bits
+    // costs one fused node compression per merge
+    uint8_t carry[32];
+    memcpy(carry, leaf, 32);
+    size_t bit = 0;
+    for (; (tree->count >> bit) & 1; bit++) {
+        sha256_merkle_node(tree->frontier[bit], carry, carry);
+    }
+    memcpy(tree->frontier[bit], carry, 32);
+    tree->count++;
+    return 0;
+}
+
+void sha256_merkle_root(const sha256_merkle_t *tree, uint8_t *dst)
+{
+    if (!tree->count) {
+        memset(dst, 0, 32);
+        return;
+    }
+
+    // Fold the frontier from the smallest subtree up — this reproduces
+    // the pair-and-promote reduction without touching the leaves
+    uint8_t carry[32];
+    int have = 0;
+    for (size_t bit = 0; tree->count >> bit; bit++) {
+        if (!((tree->count >> bit) & 1)) {
+            continue;
+        }
+        if (have) {
+            sha256_merkle_node(tree->frontier[bit], carry, carry);
+        }
+        else {
+            memcpy(carry, tree->frontier[bit], 32);
+            have = 1;
+        }
+    }
+    memcpy(dst, carry, 32);
+}
+
+int sha256_merkle_proof(const sha256_merkle_t *tree, size_t index, uint8_t (*siblings)[32], size_t *depth)
+{
+    if (index >= tree->count) {
+        return -1;
+    }
+
+    // Walk the leaf's path to the root, recording the sibling at each
+    // level; a promoted node has none and contributes no proof entry
+    size_t n = 0;
+    size_t j = index;
+    for (size_t level = 0; sha256_merkle_width(tree->count, level) > 1; level++, j /= 2) {
+        if ((j ^ 1) < sha256_merkle_width(tree->count, level)) {
+            sha256_merkle_node_at(tree, level, j ^ 1, siblings[n++]);
+        }
+    }
+    *depth = n;
+    return 0;
+}
+
+int sha256_merkle_verify(const uint8_t leaf[32], size_t index, size_t count,
+                         const uint8_t (*siblings)[32], size_t depth, const uint8_t root[32])
+{
+    if (index >= count) {
+        return 0;
+    }
+
+    uint8_t node[32];
+    memcpy(node, leaf, 32);
+    size_t n = 0;
+    size_t j = index;
+    for (size_t width = count; width > 1; width = (width + 1) / 2, j /= 2) {
+        if ((j ^ 1) >= width) {
+            continue; // promoted — no sibling at this level
+        }
+        if (n == depth) {
+            return 0;
+        }
+        if (j & 1) {
+            sha256_merkle_node(siblings[n++], node, node);
+        }
+        else {
+            sha256_merkle_node(node, siblings[n++], node);
+        }
+    }
+
+    uint32_t diff = n ^ depth;
+    for (size_t i = 0; i < 32; i++) {
+        diff |= (uint32_t)(node[i] ^ root[i]);
+    }
+    return diff == 0;
+}
+
+// Gear table for the content-defined chunker: one 64-bit constant per
+// byte value, generated once with splitmix64 and frozen so chunk
+// boundaries stay stable across builds
+static const uint64_t sha256_gear[256] = {
+    0xbb40de7834f635c8, 0x58df4cbd44d3c8a7, 0xf097ef2c65fb80c6, 0x674742fb21b3a532,
+    0x428eff1e98500a02, 0xf6add3854ce72b04, 0xed9db573809b1243, 0x69b9c663ed212e8a,
+    0x92e3dadfbbcdff03, 0x62ab03b6eb3b6f92, 0x90e7105d879c3a6d, 0x728f111fb3fe3296,
+    0xdc22345957685785, 0xead70e481d126102, 0x0cfb67d15958f9f3, 0x706d468333e8a0f4,
+    0x511736d1111fd535, 0x7d9f48d2621bff31, 0x3d21a51ea0ec0d0e, 0x8aed4cde5fdd5b9f,
+    0xd6ce73fdb9a8af34, 0x14fa1b936ca582b2, 0x02c05a69c3c1b34f, 0xa2fa7158e1b8cae4,
+    0xd5d5391a859e807a, 0x63a6018130187b12, 0x579ee2fff39dbef7, 0x1d25a793105b4ed0,
+    0xd1c28222675cf64a, 0xaa6955c8b817f11f, 0x8529029552b88bc0, 0x93e74c706b74b301,
+    0x0cac6f7d4b4cf815, 0xab72e6bd4125c8b1, 0x9344505f86b4d7ba, 0x2336f3ee89664e1a,
+    0x1b6826a1802e0254, 0x5f2938534092df6a, 0xe652f46398fd8030, 0x8502b6d88f3fceb1,
+    0xae29e3ae31d495b7, 0x27070f830fad1bbf, 0xb1e5163764a9f208, 0x12a394c330ef1519,
+    0xeb6335487b0d4d57, 0xb9ac8d12a15582bf, 0x4b2690395322ab0c, 0xa059102ec3b337ba,
+    0x6811474f199121db, 0xec9566cb79a43ca4, 0x097581bb0273c09b, 0xc1fa189d9a9d7227,
+    0x4cdf837e9bb2d23c, 0x425f48c013890dae, 0x3b3935b8927d54da, 0x310d1413330d1860,
+    0xd5b9762be8e0b6c9, 0x3baea986edcfb051, 0x0dc8c03722239c4b, 0x17e646ad18c441b8,
+    0x440262df811e25fe, 0x6ce3d9e43cd7527d, 0xd4f38ec957472162, 0x00d9027276dadc53,
+    0x43a560730e0d5304, 0xf3211a7986aeeab5, 0x69cb8be18d67da91, 0xbe4b969f89b2c2e1,
+    0x47e5725591c5fc46, 0x5f93d8c26ab68d97, 0xae23ee3917827fac, 0xd5a504bc4d5fa740,
+    0x4aab73d6a31964dd, 0x42cca81522508636, 0xd98057c2aac42e64, 0x97f3faa4e79025f7,
+    0x944853bf342a3b5e, 0x139a50660c5120b6, 0x71a9395cdc10c357, 0x54e7284b90fa0b5a,
+    0x2e98216716beef39, 0x138e9e96dfe9b563, 0x9d7191837e40f01f, 0x0b2748bf8a57513c,
+    0xe6018ac5363b4026, 0x81c9674b87beb2f0, 0xaee0a5a9371273d3, 0x0e4fd8803c309048,
+    0xdb22ec9954e0722b, 0x4bf1b7b96147249a, 0x14d6d0f37691520c, 0x763b1212bf3dcec0,
+    0x86d469ed63e278f0, 0x179a7e4149502134, 0x8ff3f7cebcbea1d4, 0x141f68744b7b2e3c,
+    0x71eb24f516b1bcd4, 0xeeaa91ca62ef938b, 0xb6859c9b911e8732, 0x9a68ee74820d2a9d,
+    0x3a1c2724ad1892c3, 0x54ab62d97cd6ac52, 0xc0175e80de6cbc47, 0x3a6c9d41bda0f59b,
+    0x2d4f754e271f9535, 0x0b7fe78aef557771, 0xbe728a9be39a6ed9, 0x09c1e0dcf1c7e57e,
+    0x4bcae9b60cdc10f8, 0x883ad1b1c6112849, 0xb3bc535f3999a606, 0x06dfa2515abaab2d,
+    0x7d5817dbde2b52f1, 0xb52433296e17ab1a, 0x444a6352d2b67ae3, 0xf67791cf06c2f7d4,
+    0xea70f6c16616ae70, 0x54cfbf5943751cb1, 0xdc600e021bd2fc83, 0x05c82531dda883f6,
+    0x2f4e6fc604b4c691, 0x9249141879328c51, 0x250a34d4f03dfd3c, 0xcc8027e0a0a30465,
+    0x15a6ddfea7595999, 0x898dc775f1066653, 0x55e6d8caf5f361d1, 0xe8c68596616e15ac,
+    0x9b2bc0d1032c4abb, 0xf3b83ef993450dfb, 0xa4f2261f9d764526, 0xf33770b7aae6a250,
+    0x2a6b099d0e3efd30, 0x010259f1ee894aa2, 0xfbe8f8ef7a1c87ba, 0xc999fc29cf3a4387,
+    0x5fd6189258f06987, 0xa7a649c3e19c9e23, 0xa0ba5cd98ee4d44c, 0xc6af6802bd2e12ae,
+    0x3273b81e804249bd, 0x2bd3a5a7fba20209, 0xfe9a6390bd4bce52, 0xf2cf4faabbd87c4d,
+    0xce068076757cef83, 0xa73bd48213bc3799, 0x2fa6bf9251be9823, 0xc574ee6f5b9e4a44,
+    0x58464248a26fcec3, 0x429fff15676e1168, 0x84e1d15fca8f58e3, 0x4db468dc3a60a096,
+    0x1457724352f22d01, 0x4666a8eb8ab95eb8, 0x7f2799e353cceb92, 0x796167029ca6844e,
+    0xf21b2e602f0e570f, 0x55bc3c8d3d6663d4, 0x487f664f839e3125, 0xd5f3baef7b6d704c,
+    0x102a4b82d640127d, 0xb256babdbc642080, 0x37b467d1f2aa12a4, 0xcd713adb4246acd3,
+    0x53a59adbf710ad81, 0x11eafaaff3b9aa6f, 0x9130f091f97ebc28, 0xd0b620940dba0444,
+    0x40f73aed04aae92d, 0x7ce35bce0d15ecdc, 0x43974f5f3e5c04ec, 0xe39b60fd44fb755a,
+    0xca2fb06326b90d74, 0x11ade400cae9aacc, 0xa09fa7a209bb3710, 0x71f82a224ccb79cd,
+    0xf8bbe78b5fed3c46, 0x832420f9557dd622, 0xa5802bcaea59796f, 0xf1d1b153a8bfcd43,
+    0x6a5cb86f4ea5a58a, 0x1fe3a38f09a96e3c, 0xa42efe6d89f8c09a, 0x075d04c45bd00b78,
+    0xc5bce9aadec9b71f, 0x6152e49a39e72ecd, 0xf24683ed961e8301, 0xb937e052609872aa,
+    0x690467a6d0c4f940, 0x56c347c478a044a0, 0xf6e9712093ff2134, 0xf9438bf927230ca7,
+    0x3777b365059176b2, 0x3c53a317aed2694f, 0x169cd05a55d76778, 0x3ea14e9cae7047ce,
+    0xe2798761dd685fd5, 0xb4108a4627727fdd, 0xfe63d0488b0ab08a, 0xc74f02d8a8bf2bdb,
+    0xd653f1f3146aa4e9, 0xc6078b26e37e4dc5, 0x9f82cf25ddc55215, 0x957f992efb1e8536,
+    0x4757c76b88ca83ab, 0xa81d309eea5523ad, 0x48db975c0cf1f5ad, 0x3c0a78e9c7decd23,
+    0xafee1ff24b2a596c, 0xec1b631915ea3f74, 0x93f664171e9c49fa, 0xa8db2c0a1aeda848,
+    0x41c5cd19fdd841cc, 0x710d4388935682c6, 0xd20c4ab277f4a635, 0x67a6e72e5809b8bc,
+    0x9b89891ddeac220d, 0xb74667cd1ee9f3ed, 0x131343ef13849651, 0xbb504d03133c787f,
+    0xb56b9a2346a2e927, 0x5191af37cbbcdf8c, 0x63ceeb06028386b3, 0xf3f2053e2deb9d5b,
+    0x7fbb4888604c465e, 0x78de6e5aff618140, 0x2adef2a4e4ce976f, 0xd1b5fc4bf5145db6,
+    0x161881aae4ca9139, 0xbbb1c2af2f00b9e3, 0x68fca1f76bb4b88b, 0xd222cad3c141a298,
+    0x5fbc38a36818fc8e, 0xeeb09f4d5ea2e5f9, 0xe530bb8c1481b061, 0x6b52509925aab8bb,
+    0x0c32318f7403f135, 0xfd2f7dc325829a9c, 0x7d5e02f41ce00b87, 0xa8beb0a4e89c613b,
+    0x4bb8857a04bfa044, 0x8ba82c557764c5cc, 0x89c255161396f262, 0xeec285e856943dfc,
+    0xc14a41eb6008b602, 0xb87969a8b03d7fd5, 0x029f99238eb72a86, 0xeb1b4bb74c7032b9,
+    0x001ff8f59a8f3534, 0xbca39e84738b280e, 0xde9e799a46ef55c1, 0x296b172ffd808c99,
+    0xfeb1284f4a52c532, 0x4eabb6a8aeb266e0, 0xb6589f8ad9262922, 0x67f24c3d771d1a5f
+};
+
+int sha256_chunks(const void *src, size_t len, size_t min_len, size_t avg_len, size_t max_len,
+                  sha256_chunk_fn emit, void *arg)
+{
+    if (!emit || !min_len || min_len > avg_len || avg_len > max_len) {
+        return -1;
+    }
+
+    // Boundary test fires when the low bits of the rolling hash clear;
+    // a mask of ceil(log2(avg_len)) bits puts the expected chunk size
+    // near avg_len
+    uint64_t mask = 1;
+    while (mask < avg_len) {
+        mask <<= 1;
+    }
+    mask -= 1;
+
+    const uint8_t *data = (const uint8_t *)src;
+    uint64_t offset = 0;
+    while (len) {
+        // Scan for the next cut point: gear hash h <- (h << 1) + g[byte]
+        // carries an implicit 64-byte window, so it restarts at zero per
+        // chunk and boundaries before min_len aren't tested
+        size_t cut = len < max_len ? len : max_len;
+        uint64_t h = 0;
+        for (size_t i = min_len; i < cut; i++) {
+            h = (h << 1) + sha256_gear[data[i]];
+            if (!(h & mask)) {
+                cut = i + 1;
+                break;
+            }
+        }
+
+        // Fingerprint the chunk while its bytes are still cache-hot
+        // from the scan — one trip through memory for both passes
+        uint8_t digest[32];
+        sha256(data, cut, digest);
+        emit(offset, cut, digest, arg);
+
+        data += cut;
+        offset += cut;
+        len -= cut;
+    }
+    return 0;
+}
+
+// Streaming read-loop chunk size for descriptors that can't be mapped
+#define SHA256_FILE_CHUNK (256 * 1024)
+
+#if SHA256_POSIX
+int sha256_fd(int fd, void *dst)
+{
+    struct stat st;
+    if (fstat(fd, &st)) {
+        return -1;
+    }
+
+    // Map regular files and hash straight out of the page cache
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        const size_t len = (size_t)st.st_size;
+        void *map = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            (void)madvise(map, len, MADV_SEQUENTIAL);
+            sha256(map, len, dst);
+            munmap(map, len);
+            return 0;
+        }
+    }
+
+    // Pipes, sockets, devices, or a failed map: stream in large spans
+    uint8_t *buf = (uint8_t *)malloc(SHA256_FILE_CHUNK);
+    if (!buf) {
+        return -1;
+    }
+    sha256_t ctx;
+    sha256_init(&ctx);
+    for (;;) {
+        const ssize_t n = read(fd, buf, SHA256_FILE_CHUNK);
+        if (n > 0) {
+            sha256_append(&ctx, buf, (size_t)n);
+            continue;
+        }
+        if (n == 0) {
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        free(buf);
+        return -1;
+    }
+    free(buf);
+    sha256_finish(&ctx, dst);
+    return 0;
+}
+
+int sha256_file(const char *path, void *dst)
+{
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    const int ret = sha256_fd(fd, dst);
+    close(fd);
+    return ret;
+}
+#else
+int sha256_file(const char *path, void *dst)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return -1;
+    }
+    uint8_t *buf = (uint8_t *)malloc(SHA256_FILE_CHUNK);
+    if (!buf) {
+        fclose(f);
+        return -1;
+    }
+    sha256_t ctx;
+    sha256_init(&ctx);
+    size_t n;
+    while ((n = fread(buf, 1, SHA256_FILE_CHUNK, f)) > 0) {
+        sha256_append(&ctx, buf, n);
+    }
+    const int ret = ferror(f) ? -1 : 0;
+    free(buf);
+    fclose(f);
+    if (!ret) {
+        sha256_finish(&ctx, dst);
+    }
+    return ret;
+}
+#endif
+
+#if SHA256_POSIX
+// Files at or below this size get read whole and hashed through the
+// multi-buffer kernel; larger ones go through sha256_fd individually
+#ifndef SHA256_MANIFEST_SMALL
+    #define SHA256_MANIFEST_SMALL (64 * 1024)
+#endif
+
+// How many entries a worker claims from the shared cursor at a time —
+// also the multi-buffer kernel width, so a claim of all-small files
+// fills one x8 pass exactly
+#define SHA256_MANIFEST_BATCH 8
+
+typedef struct sha256_manifest_job_t {
+    char **paths;
+    size_t count;
+    size_t next;          // guarded by lock
+    pthread_mutex_t lock; // serializes claims and emit callbacks
+    sha256_manifest_fn emit;
+    void *arg;
+    int error;
+} sha256_manifest_job_t;
+
+// Depth-first walk collecting regular-file paths into a growable array
+static int sha256_manifest_walk(const char *dir, char ***paths, size_t *count, size_t *cap)
+{
+    DIR *d = opendir(dir);
+    if (!d) {
+        return -1;
+    }
+
+    int ret = 0;
+    const struct dirent *entry;
+    while ((entry = readdir(d))) {
+        if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) {
+            continue;
+        }
+        const size_t dir_len = strlen(dir);
+        const size_t name_len = strlen(entry->d_name);
+        char *path = (char *)malloc(dir_len + name_len + 2);
+        if (!path) {
+            ret = -1;
+            break;
+        }
+        memcpy(path, dir, dir_len);
+        path[dir_len] = '/';
+        memcpy(&path[dir_len + 1], entry->d_name, name_len + 1);
+
+        // lstat rather than d_type: d_type is optional, and symlinks are
+        // skipped instead of followed so link cycles can't recurse forever
+        struct stat st;
+        if (lstat(path, &st)) {
+            free(path);
+            ret = -1;
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            if (sha256_manifest_walk(path, paths, count, cap)) {
+                ret = -1;
+            }
+            free(path);
+            continue;
+        }
+        if (!S_ISREG(st.st_mode)) {
+            free(path);
+            continue;
+        }
+
+        if (*count == *cap) {
+            const size_t grown = *cap ? 2 * *cap : 64;
+            char **resized = (char **)realloc(*paths, grown * sizeof(char *));
+            if (!resized) {
+                free(path);
+                ret = -1;
+                break;
+            }
+            *paths = resized;
+            *cap = grown;
+        }
+        (*paths)[(*count)++] = path;
+    }
+    closedir(d);
+    return ret;
+}
+
+// Read a small file in full; returns its size or -1
+static ssize_t sha256_manifest_slurp(int fd, uint8_t *buf, size_t size)
+{
+    size_t have = 0;
+    while (have < size) {
+        const ssize_t n = read(fd, &buf[have], size - have);
+        if (n > 0) {
+            have += (size_t)n;
+            continue;
+        }
+        if (n == 0) {
+            break; // truncated since lstat — hash what's there
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        return -1;
+    }
+    return (ssize_t)have;
+}
+
+// Failure paths are cold, so the claim/emit lock doubles as the error
+// flag's synchronization
+static void sha256_manifest_fail(sha256_manifest_job_t *job)
+{
+    pthread_mutex_lock(&job->lock);
+    job->error = -1;
+    pthread_mutex_unlock(&job->lock);
+}
+
+static void *sha256_manifest_worker(void *arg)
+{
+    sha256_manifest_job_t *job = (sha256_manifest_job_t *)arg;
+
+    for (;;) {
+        // Claim a batch of entries off the shared cursor
+        pthread_mutex_lock(&job->lock);
+        const size_t lo = job->next;
+        size_t hi = lo + SHA256_MANIFEST_BATCH;
+        if (hi > job->count) {
+            hi = job->count;
+        }
+        job->next = hi;
+        pthread_mutex_unlock(&job->lock);
+        if (lo >= hi) {
+            return NULL;
+        }
+
+        // Small files collect into one multi-buffer pass; big files
+        // stream through sha256_fd as they're encountered
+        uint8_t *bufs[SHA256_MANIFEST_BATCH];
+        const void *srcs[SHA256_MANIFEST_BATCH];
+        size_t lens[SHA256_MANIFEST_BATCH];
+        const char *names[SHA256_MANIFEST_BATCH];
+        size_t nsmall = 0;
+
+        for (size_t i = lo; i < hi; i++) {
+            const int fd = open(job->paths[i], O_RDONLY | O_CLOEXEC);
+            struct stat st;
+            if (fd < 0 || fstat(fd, &st)) {
+                if (fd >= 0) {
+                    close(fd);
+                }
+                sha256_manifest_fail(job);
+                continue;
+            }
+
+            if ((uint64_t)st.st_size > SHA256_MANIFEST_SMALL) {
+                uint8_t digest[32];
+                const int ret = sha256_fd(fd, digest);
+                close(fd);
+                if (ret) {
+                    sha256_manifest_fail(job);
+                    continue;
+                }
+                pthread_mutex_lock(&job->lock);
+                job->emit(job->paths[i], (uint64_t)st.st_size, digest, job->arg);
+                pthread_mutex_unlock(&job->lock);
+                continue;
+            }
+
+            uint8_t *buf = (uint8_t *)malloc(st.st_size ? (size_t)st.st_size : 1);
+            const ssize_t got = buf ? sha256_manifest_slurp(fd, buf, (size_t)st.st_size) : -1;
+            close(fd);
+            if (got < 0) {
+                free(buf);
+                sha256_manifest_fail(job);
+                continue;
+            }
+            bufs[nsmall] = buf;
+            srcs[nsmall] = buf;
+            lens[nsmall] = (size_t)got;
+            names[nsmall] = job->paths[i];
+            nsmall++;
+        }
+
+        if (nsmall) {
+            uint8_t digests[SHA256_MANIFEST_BATCH][32];
+            sha256_hash_nway(srcs, lens, nsmall, digests);
+            pthread_mutex_lock(&job->lock);
+            for (size_t i = 0; i < nsmall; i++) {
+                job->emit(names[i], lens[i], digests[i], job->arg);
+            }
+            pthread_mutex_unlock(&job->lock);
+            for (size_t i = 0; i < nsmall; i++) {
+                free(bufs[i]);
+            }
+        }
+    }
+}
+
+int sha256_manifest(const char *dir, size_t nthreads, sha256_manifest_fn emit, void *arg)
+{
+    if (!emit) {
+        return -1;
+    }
+
+    char **paths = NULL;
+    size_t count = 0;
+    size_t cap = 0;
+    int ret = sha256_manifest_walk(dir, &paths, &count, &cap);
+
+    sha256_manifest_job_t job = {
+        .paths = paths,
+        .count = count,
+        .emit = emit,
+        .arg = arg,
+    };
+    pthread_mutex_init(&job.lock, NULL);
+
+    // Cap the pool at one worker per batch and fall back to hashing on
+    // the calling thread when spawning fails
+    size_t nspawn = nthreads > 1 ? nthreads - 1 : 0;
+    const size_t batches = (count + SHA256_MANIFEST_BATCH - 1) / SHA256_MANIFEST_BATCH;
+    if (nspawn >= batches) {
+        nspawn = batches ? batches - 1 : 0;
+    }
+    pthread_t *tids = nspawn ? (pthread_t *)malloc(nspawn * sizeof(pthread_t)) : NULL;
+    size_t spawned = 0;
+    if (tids) {
+        for (; spawned < nspawn; spawned++) {
+            if (pthread_create(&tids[spawned], NULL, sha256_manifest_worker, &job)) {
+                break;
+            }
+        }
+    }
+    sha256_manifest_worker(&job);
+    for (size_t i = 0; i < spawned; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    free(tids);
+
+    if (job.error) {
+        ret = -1;
+    }
+    pthread_mutex_destroy(&job.lock);
+    for (size_t i = 0; i < count; i++) {
+        free(paths[i]);
+    }
+    free(paths);
+    return ret;
+}
+#endif
+
+void hmac_sha256_init(hmac_sha256_t *ctx, const void *key, size_t len)
+{
+    // Keys longer than a block get hashed down first (RFC 2104)
+    uint8_t block[64] = { 0 };
+    if (len > 64) {
+        sha256(key, len, block);
+    }
+    else {
+        memcpy(block, key, len);
+    }
+
+    // One compression each for K ^ ipad and K ^ opad, cached as midstates
+    for (size_t i = 0; i < 64; i++) {
+        block[i] ^= 0x36;
+    }
+    sha256_init(&ctx->inner);
+    sha256_append(&ctx->inner, block, 64);
+    sha256_save(&ctx->inner, &ctx->istate);
+
+    for (size_t i = 0; i < 64; i++) {
+        block[i] ^= 0x36 ^ 0x5c;
+    }
+    sha256_t outer;
+    sha256_init(&outer);
+    sha256_append(&outer, block, 64);
+    sha256_save(&outer, &ctx->ostate);
+
+    memset(block, 0, sizeof(block)); // don't leave key material on the stack
+}
+
+void hmac_sha256_append(hmac_sha256_t *ctx, const void *src, size_t len)
+{
+    sha256_append(&ctx->inner, src, len);
+}
+
+void hmac_sha256_finish(hmac_sha256_t *ctx, void *dst)
+{
+    uint8_t digest[32];
+    sha256_finish(&ctx->inner, digest);
+
+    sha256_t outer;
+    sha256_restore(&outer, &ctx->ostate);
+    sha256_append(&outer, digest, 32);
+    sha256_finish(&outer, dst);
+}
+
+void hmac_sha256_reset(hmac_sha256_t *ctx)
+{
+    sha256_restore(&ctx->inner, &ctx->istate);
+}
+
+void hkdf_sha256_extract(const void *salt, size_t salt_len, const void *ikm, size_t ikm_len, uint8_t *prk)
+{
+    // PRK = HMAC(salt, IKM); no salt means HashLen zero bytes (RFC 5869)
+    static const uint8_t zeros[32] = { 0 };
+    hmac_sha256_t mac;
+    hmac_sha256_init(&mac, salt ? salt : zeros, salt ? salt_len : sizeof(zeros));
+    hmac_sha256_append(&mac, ikm, ikm_len);
+    hmac_sha256_finish(&mac, prk);
+    memset(&mac, 0, sizeof(mac));
+}
+
+int hkdf_sha256_expand(const uint8_t *prk, const void *info, size_t info_len, void *okm, size_t okm_len)
+{
+    if (okm_len > 255 * 32) {
+        return -1;
+    }
+
+    // The PRK key schedule (K ^ ipad / K ^ opad compressions) runs once
+    // here; each T(n) iteration rewinds to the cached inner midstate
+    // instead of re-keying
+    hmac_sha256_t mac;
+    hmac_sha256_init(&mac, prk, 32);
+
+    uint8_t t[32];
+    uint8_t *out = (uint8_t *)okm;
+    size_t tlen = 0;
+    for (uint8_t counter = 1; okm_len; counter++) {
+        hmac_sha256_reset(&mac);
+        if (tlen) {
+            hmac_sha256_append(&mac, t, tlen);
+        }
+        if (info_len) {
+            hmac_sha256_append(&mac, info, info_len);
+        }
+        hmac_sha256_append(&mac, &counter, 1);
+        hmac_sha256_finish(&mac, t);
+        tlen = sizeof(t);
+
+        const size_t n = okm_len < sizeof(t) ? okm_len : sizeof(t);
+        memcpy(out, t, n);
+        out += n;
+        okm_len -= n;
+    }
+
+    memset(t, 0, sizeof(t));
+    memset(&mac, 0, sizeof(mac)); // midstates are key material
+    return 0;
+}
+
+int sha256_batch_init(sha256_batch_t *batch, size_t capacity)
+{
+    memset(batch, 0, sizeof(sha256_batch_t));
+    batch->srcs = (const void **)malloc(capacity * sizeof(void *));
+    batch->lens = (size_t *)malloc(capacity * sizeof(size_t));
+    batch->expected = (const uint8_t **)malloc(capacity * sizeof(uint8_t *));
+    if (!batch->srcs || !batch->lens || !batch->expected) {
+        sha256_batch_free(batch);
+        return -1;
+    }
+    batch->cap = capacity;
+    return 0;
+}
+
+int sha256_batch_push(sha256_batch_t *batch, const void *src, size_t len, const uint8_t expected[32])
+{
+    if (batch->count == batch->cap) {
+        return -1;
+    }
+    batch->srcs[batch->count] = src;
+    batch->lens[batch->count] = len;
+    batch->expected[batch->count] = expected;
+    batch->count++;
+    return 0;
+}
+
+// Verify jobs [lo, hi) eight at a time through the multi-buffer kernel
+static void sha256_batch_slice(const sha256_batch_t *batch, int *results, size_t lo, size_t hi)
+{
+    uint8_t digests[8][32];
+    while (lo < hi) {
+        const size_t n = hi - lo > 8 ? 8 : hi - lo;
+        sha256_hash_nway(&batch->srcs[lo], &batch->lens[lo], n, digests);
+        for (size_t i = 0; i < n; i++) {
+            results[lo + i] = !memcmp(digests[i], batch->expected[lo + i], 32);
+        }
+        lo += n;
+    }
+}
+
+#if SHA256_POSIX
+typedef struct sha256_batch_job_t {
+    const sha256_batch_t *batch;
+    int *results;
+    size_t lo;
+    size_t hi;
+} sha256_batch_job_t;
+
+static void *sha256_batch_worker(void *arg)
+{
+    sha256_batch_job_t *job = (sha256_batch_job_t *)arg;
+    sha256_batch_slice(job->batch, job->results, job->lo, job->hi);
+    return NULL;
+}
+#endif
+
+size_t sha256_batch_run(const sha256_batch_t *batch, size_t nthreads, int *results)
+{
+#if SHA256_POSIX
+    if (nthreads > batch->count) {
+        nthreads = batch->count;
+    }
+    if (nthreads > 1) {
+        pthread_t *tids = (pthread_t *)malloc(nthreads * sizeof(pthread_t));
+        sha256_batch_job_t *jobs = (sha256_batch_job_t *)malloc(nthreads * sizeof(sha256_batch_job_t));
+        if (!tids || !jobs) {
+            nthreads = 1; // fall through to the serial path
+        }
+        else {
+            for (size_t t = 0; t < nthreads; t++) {
+                jobs[t] = (sha256_batch_job_t) {
+                    .batch = batch,
+                    .results = results,
+                    .lo = batch->count * t / nthreads,
+                    .hi = batch->count * (t + 1) / nthreads,
+                };
+            }
+            size_t spawned = 0;
+            for (size_t t = 0; t + 1 < nthreads; t++) {
+                if (pthread_create(&tids[spawned], NULL, sha256_batch_worker, &jobs[t])) {
+                    sha256_batch_worker(&jobs[t]);
+                    continue;
+                }
+                spawned++;
+            }
+            sha256_batch_worker(&jobs[nthreads - 1]);
+            for (size_t t = 0; t < spawned; t++) {
+                pthread_join(tids[t], NULL);
+            }
+        }
+        free(tids);
+        free(jobs);
+    }
+    if (nthreads <= 1)
+#else
+    (void)nthreads;
+#endif
+    {
+        sha256_batch_slice(batch, results, 0, batch->count);
+    }
+
+    size_t failures = 0;
+    for (size_t i = 0; i < batch->count; i++) {
+        failures += !results[i];
+    }
+    return failures;
+}
+
+void sha256_batch_clear(sha256_batch_t *batch)
+{
+    batch->count = 0;
+}
+
+void sha256_batch_free(sha256_batch_t *batch)
+{
+    free(batch->srcs);
+    free(batch->lens);
+    free(batch->expected);
+    memset(batch, 0, sizeof(sha256_batch_t));
+}
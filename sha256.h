@@ -15,11 +15,38 @@
 #include <stdint.h>
 #include <string.h>
 
-typedef struct sha256_t {
-    uint8_t data[64];
-    uint64_t block_bytes;
-    uint64_t bits_total;
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/uio.h>
+#endif
+
+#if defined(__GNUC__)
+    #define SHA256_ALIGN __attribute__((aligned(64)))
+#else
+    #define SHA256_ALIGN
+#endif
+
+// Hot members first: the state words and counters share the first cache
+// line, with the staging buffer — only touched by unaligned appends and
+// finalization — filling the second
+#ifdef SHA256_STATS
+// Fires after every N compressed blocks when armed via sha256_sample
+typedef void (*sha256_sample_fn)(uint64_t blocks, void *arg);
+#endif
+
+typedef struct SHA256_ALIGN sha256_t {
     uint32_t state[8];
+    uint64_t bits_total;
+    uint64_t block_bytes;
+    uint8_t data[64];
+#ifdef SHA256_STATS
+    uint64_t stat_blocks;
+    uint64_t stat_bulk_bytes;
+    uint64_t stat_buffered_bytes;
+    uint64_t sample_every;
+    uint64_t sample_next;
+    sha256_sample_fn sample_fn;
+    void *sample_arg;
+#endif
 } sha256_t;
 
 /**
@@ -29,6 +56,19 @@ typedef struct sha256_t {
  */
 void sha256_init(sha256_t *ctx);
 
+/**
+ * @brief Reset a context without scrubbing the staging buffer
+ *
+ * Restores the IV and zeroes the counters — 48 bytes touched instead of
+ * the full context, for reinit-per-request hot paths. Stale data[]
+ * bytes are never read back (padding only writes past block_bytes), so
+ * the digest is unaffected; use sha256_init if leftover input must not
+ * linger in memory.
+ *
+ * @param[inout] ctx sha256_t instance
+ */
+void sha256_reset(sha256_t *ctx);
+
 /**
  * @brief Append data to hash
  *
@@ -45,3 +85,589 @@ void sha256_append(sha256_t *ctx, const void *src, size_t len);
  * @param[out] dst destination
  */
 void sha256_finish(sha256_t *ctx, void *dst);
+
+/**
+ * @brief Append a large, cold buffer without dragging it through cache
+ *
+ * Identical result to sha256_append. Buffers past a size threshold
+ * (SHA256_STREAM_THRESHOLD, 256 KiB unless overridden) are walked with
+ * non-temporal prefetches a few blocks ahead, so hashing a huge
+ * snapshot doesn't evict a co-resident working set. Small appends
+ * forward to sha256_append unchanged.
+ *
+ * @param[inout] ctx sha256_t context
+ * @param[in] src data to be processed into this hash context
+ * @param[in] len number of bytes to process
+ */
+void sha256_append_stream(sha256_t *ctx, const void *src, size_t len);
+
+/**
+ * @brief Append at most max_bytes of src, for cooperative scheduling
+ *
+ * Processes min(len, max_bytes) bytes and reports how many were taken,
+ * so an event loop can hash a large buffer across multiple calls
+ * without blocking on the whole thing. Feeding the remainder back in
+ * (src + consumed, len - consumed) on the next call yields the same
+ * digest as a single sha256_append of the full buffer.
+ *
+ * @param[inout] ctx sha256_t context
+ * @param[in] src data to be processed into this hash context
+ * @param[in] len number of bytes remaining in src
+ * @param[in] max_bytes per-call work budget in bytes
+ * @param[out] consumed bytes processed this call (may be NULL)
+ * @return bytes of src still unprocessed
+ */
+size_t sha256_append_budget(sha256_t *ctx, const void *src, size_t len, size_t max_bytes, size_t *consumed);
+
+/**
+ * @brief Name of the compression backend in use on this host
+ *
+ * Backends are normally picked at runtime by CPU detection. Fixed
+ * targets can pin one at compile time instead — build sha256.c with
+ * SHA256_BACKEND_SCALAR, SHA256_BACKEND_SHANI, or SHA256_BACKEND_ARMV8
+ * defined to compile exactly that kernel with no dispatch indirection
+ * and the others omitted from the binary.
+ *
+ * @return "sha-ni", "armv8-crypto", or "scalar"
+ */
+const char *sha256_backend(void);
+
+#ifdef SHA256_STATS
+// Per-context instrumentation, compiled in only when SHA256_STATS is
+// defined for both sha256.c and every includer of this header — the
+// context layout changes with the flag. Counters cover the streaming
+// paths (append, append_stream, finish); the multi-buffer and
+// two-stream kernels don't run through a context and aren't attributed.
+typedef struct sha256_stats_t {
+    uint64_t blocks;         // compressions charged to this context
+    uint64_t bulk_bytes;     // hashed straight from caller buffers
+    uint64_t buffered_bytes; // staged through the context block first
+    const char *backend;     // as reported by sha256_backend()
+} sha256_stats_t;
+
+/**
+ * @brief Snapshot a context's counters
+ *
+ * Counters start at zero from sha256_init and keep accumulating across
+ * sha256_reset, so one context reused per tenant attributes all of that
+ * tenant's hashing.
+ *
+ * @param[in] ctx sha256_t context
+ * @param[out] out counter snapshot
+ */
+void sha256_stats(const sha256_t *ctx, sha256_stats_t *out);
+
+/**
+ * @brief Arm a sampling callback on a context
+ *
+ * fn fires from inside append/finish after every `every` compressed
+ * blocks — keep it cheap. every = 0 (or fn = NULL) disarms.
+ *
+ * @param[inout] ctx sha256_t context
+ * @param[in] every blocks between callbacks
+ * @param[in] fn callback receiving the running block count
+ * @param[in] arg opaque pointer passed through to the callback
+ */
+void sha256_sample(sha256_t *ctx, uint64_t every, sha256_sample_fn fn, void *arg);
+#endif
+
+// Compressed chaining state captured at a 512-bit block boundary
+typedef struct sha256_midstate_t {
+    uint32_t state[8];
+    uint64_t bits_total;
+} sha256_midstate_t;
+
+/**
+ * @brief Duplicate a context, buffered partial block included
+ *
+ * Hash a common prefix once, clone it per message, and resume each clone
+ * independently — the source context is untouched.
+ *
+ * @param[in] src context to copy
+ * @param[out] dst destination context
+ */
+void sha256_clone(const sha256_t *src, sha256_t *dst);
+
+/**
+ * @brief Snapshot the compressed chaining state
+ *
+ * Only whole compressed blocks are captured: take the snapshot when the
+ * bytes appended so far are a multiple of 64, or the buffered tail is
+ * lost. Use sha256_clone for arbitrary split points.
+ *
+ * @param[in] ctx context to snapshot
+ * @param[out] mid midstate destination
+ */
+void sha256_save(const sha256_t *ctx, sha256_midstate_t *mid);
+
+/**
+ * @brief Resume hashing from a saved midstate
+ *
+ * @param[inout] ctx context to (re)initialize from the snapshot
+ * @param[in] mid previously saved midstate
+ */
+void sha256_restore(sha256_t *ctx, const sha256_midstate_t *mid);
+
+// Serialized context layout: state words (32 B, each little-endian),
+// bits_total (8 B little-endian), buffered byte count (1 B), buffered
+// tail (63 B, zero-padded) — stable across ABIs and endianness
+#define SHA256_EXPORT_SIZE 104
+
+/**
+ * @brief Serialize a context into a stable, portable byte layout
+ *
+ * Captures everything including a buffered partial block, so a
+ * long-running hash can be checkpointed to disk and resumed after a
+ * restart — even on a host with different endianness or struct layout.
+ *
+ * @param[in] ctx context to serialize
+ * @param[out] out SHA256_EXPORT_SIZE-byte destination
+ */
+void sha256_export(const sha256_t *ctx, uint8_t out[SHA256_EXPORT_SIZE]);
+
+/**
+ * @brief Reconstruct a context from sha256_export output
+ *
+ * @param[inout] ctx context to fill in
+ * @param[in] in SHA256_EXPORT_SIZE bytes from sha256_export
+ * @return 0 on success, -1 if the blob is malformed
+ */
+int sha256_import(sha256_t *ctx, const uint8_t in[SHA256_EXPORT_SIZE]);
+
+/**
+ * @brief One-shot hash of a complete message
+ *
+ * Equivalent to init/append/finish but keeps all state in locals —
+ * no context struct, no staging through an internal block buffer.
+ *
+ * @param[in] src data to be hashed
+ * @param[in] len number of bytes to hash
+ * @param[out] dst 32-byte destination
+ */
+void sha256(const void *src, size_t len, void *dst);
+
+/**
+ * @brief Finish computation and compare against an expected digest
+ *
+ * Replaces the finish-into-buffer-then-memcmp pattern on hot verify
+ * paths: the digest stays in locals and the comparison accumulates over
+ * all 32 bytes so it can't short-circuit into a timing oracle.
+ *
+ * @param[inout] ctx sha256_t context
+ * @param[in] expected expected 32-byte digest
+ * @return 1 if the digest matches, 0 otherwise
+ */
+int sha256_verify(sha256_t *ctx, const uint8_t expected[32]);
+
+/**
+ * @brief Initialize a context for SHA-224
+ *
+ * Same machinery as SHA-256 with the alternate IV (5.3.1); feed data
+ * with sha256_append and close with sha224_finish.
+ *
+ * @param[inout] ctx sha256_t instance
+ */
+void sha224_init(sha256_t *ctx);
+
+/**
+ * @brief Finish a SHA-224 computation and output the truncated hash
+ *
+ * @param[inout] ctx context started with sha224_init
+ * @param[out] dst 28-byte destination
+ */
+void sha224_finish(sha256_t *ctx, void *dst);
+
+/**
+ * @brief One-shot SHA-224 of a complete message
+ *
+ * @param[in] src data to be hashed
+ * @param[in] len number of bytes to hash
+ * @param[out] dst 28-byte destination
+ */
+void sha224(const void *src, size_t len, void *dst);
+
+/**
+ * @brief Fused double SHA-256: SHA256(SHA256(src))
+ *
+ * The outer hash of the 32-byte inner digest is a single pre-padded
+ * compression — no second context setup or padding pass.
+ *
+ * @param[in] src data to be hashed
+ * @param[in] len number of bytes to hash
+ * @param[out] dst 32-byte destination
+ */
+void sha256d(const void *src, size_t len, void *dst);
+
+/**
+ * @brief One-shot hash of exactly 64 bytes
+ *
+ * Same digest as sha256(src, 64, dst), specialized for the fixed
+ * length: no padding construction, and the finishing block's message
+ * schedule is a precomputed constant, so only its 64 rounds run. Built
+ * for Merkle interior nodes (two concatenated 32-byte digests) and
+ * other fixed-64-byte workloads.
+ *
+ * @param[in] src exactly 64 bytes to hash
+ * @param[out] dst 32-byte destination
+ */
+void sha256_block64(const uint8_t src[64], uint8_t dst[32]);
+
+/**
+ * @brief Hash `count` independent messages, N at a time
+ *
+ * Runs up to 8 message schedules side-by-side in SIMD lanes on capable
+ * hardware, falling back to one-at-a-time hashing otherwise. Output is
+ * identical to hashing each message with init/append/finish.
+ *
+ * @param[in] srcs array of `count` message pointers
+ * @param[in] lens array of `count` message lengths
+ * @param[in] count number of messages
+ * @param[out] digests destination for `count` 32-byte digests
+ */
+void sha256_hash_nway(const void *const *srcs, const size_t *lens, size_t count, uint8_t (*digests)[32]);
+
+/**
+ * @brief Compress one 512-bit block into each of two independent contexts
+ *
+ * Interleaves the rounds of both blocks in a single scalar kernel so the
+ * two dependency chains fill ALU ports a lone stream leaves idle — the
+ * win on cores without SHA instructions. Both contexts must be at a
+ * block boundary (no buffered partial block), as with block-aligned
+ * sha256_append usage; finish each context normally.
+ *
+ * @param[inout] ctx_a first context
+ * @param[in] da 64 bytes to compress into ctx_a
+ * @param[inout] ctx_b second context
+ * @param[in] db 64 bytes to compress into ctx_b
+ */
+void sha256_hash2(sha256_t *ctx_a, const uint8_t *da, sha256_t *ctx_b, const uint8_t *db);
+
+/**
+ * @brief Merkle tree hash of a large buffer, leaves hashed in parallel
+ *
+ * The buffer is split into SHA256_TREE_LEAF_SIZE leaves (1 MiB unless
+ * overridden at compile time), each leaf is hashed independently, and a
+ * binary tree is built over the leaf digests — interior nodes hash the
+ * concatenation of their two children, an odd node is promoted as-is.
+ * Note the root is NOT equal to the flat sha256() of the buffer.
+ *
+ * @param[in] src data to be hashed
+ * @param[in] len number of bytes to hash
+ * @param[in] nthreads worker thread count (0 or 1 hashes on the calling thread)
+ * @param[out] dst 32-byte destination for the root digest
+ * @return 0 on success, -1 if scratch allocation failed
+ */
+int sha256_tree(const void *src, size_t len, size_t nthreads, void *dst);
+
+// Receives one record per content-defined chunk, in buffer order
+typedef void (*sha256_chunk_fn)(uint64_t offset, size_t len, const uint8_t digest[32], void *arg);
+
+/**
+ * @brief Content-defined chunking and fingerprinting in one pass
+ *
+ * Runs a Gear rolling hash to find chunk boundaries and hashes each
+ * chunk immediately after its boundary scan, while the bytes are still
+ * cache-hot — one trip through memory instead of the separate
+ * chunk-then-fingerprint passes a dedup pipeline would otherwise make.
+ * Boundaries depend only on content and the frozen gear table, so the
+ * same data always cuts in the same places. Chunk sizes land near
+ * avg_len (rounded up to a power of two) and are clamped to
+ * [min_len, max_len]; the final chunk may be shorter than min_len.
+ *
+ * @param[in] src data to be chunked and hashed
+ * @param[in] len number of bytes
+ * @param[in] min_len smallest chunk to emit (boundary scan skips this prefix)
+ * @param[in] avg_len target average chunk size
+ * @param[in] max_len forced cut point
+ * @param[in] emit callback receiving (offset, len, digest) per chunk
+ * @param[in] arg opaque pointer passed through to the callback
+ * @return 0 on success, -1 on NULL callback or min > avg or avg > max
+ */
+int sha256_chunks(const void *src, size_t len, size_t min_len, size_t avg_len, size_t max_len,
+                  sha256_chunk_fn emit, void *arg);
+
+// Upper bound on tree depth and therefore on proof length, in nodes
+#define SHA256_MERKLE_DEPTH 64
+
+// Append-only Merkle tree over 32-byte record digests. The frontier
+// holds one complete-subtree root per set bit of count, so the running
+// root updates in O(log n) without reloading leaves; the leaves stay
+// stored for proof generation. Node rule matches sha256_tree: children
+// concatenate, an odd node is promoted unchanged.
+typedef struct sha256_merkle_t {
+    uint8_t (*leaves)[32];
+    size_t count;
+    size_t cap;
+    uint8_t frontier[SHA256_MERKLE_DEPTH][32];
+} sha256_merkle_t;
+
+/**
+ * @brief Initialize an empty Merkle tree
+ *
+ * @param[inout] tree sha256_merkle_t instance
+ */
+void sha256_merkle_init(sha256_merkle_t *tree);
+
+/**
+ * @brief Release leaf storage and clear the tree
+ *
+ * @param[inout] tree sha256_merkle_t instance
+ */
+void sha256_merkle_free(sha256_merkle_t *tree);
+
+/**
+ * @brief Append a record digest as the next leaf
+ *
+ * Costs one fused two-digest compression per trailing set bit of the
+ * leaf count — O(log n) amortizing to O(1) — with no per-node context
+ * setup.
+ *
+ * @param[inout] tree sha256_merkle_t instance
+ * @param[in] leaf 32-byte record digest
+ * @return 0 on success, -1 if leaf storage couldn't grow
+ */
+int sha256_merkle_append(sha256_merkle_t *tree, const uint8_t leaf[32]);
+
+/**
+ * @brief Current root over all appended leaves
+ *
+ * Folds the frontier — O(log n) fused compressions, no leaf access.
+ * The root of an empty tree is all zero bytes.
+ *
+ * @param[in] tree sha256_merkle_t instance
+ * @param[out] dst 32-byte destination for the root digest
+ */
+void sha256_merkle_root(const sha256_merkle_t *tree, uint8_t *dst);
+
+/**
+ * @brief Inclusion proof for the leaf at `index`
+ *
+ * Writes the sibling digest for each level of the leaf's path, bottom
+ * up; levels where the path node is promoted contribute no entry.
+ * Siblings are recomputed from the stored leaves, so proof generation
+ * is O(n) hashing — appends and roots stay cheap, proofs pay.
+ *
+ * @param[in] tree sha256_merkle_t instance
+ * @param[in] index leaf to prove, < count
+ * @param[out] siblings room for SHA256_MERKLE_DEPTH sibling digests
+ * @param[out] depth number of siblings written
+ * @return 0 on success, -1 if index is out of range
+ */
+int sha256_merkle_proof(const sha256_merkle_t *tree, size_t index, uint8_t (*siblings)[32], size_t *depth);
+
+/**
+ * @brief Check an inclusion proof against a root
+ *
+ * Needs no tree — just the leaf, its index, the leaf count the root was
+ * taken at, and the proof. Comparison is constant-time in the digests.
+ *
+ * @param[in] leaf 32-byte record digest being proven
+ * @param[in] index position the leaf claims in the sequence
+ * @param[in] count leaf count at the time the root was computed
+ * @param[in] siblings proof from sha256_merkle_proof
+ * @param[in] depth number of siblings in the proof
+ * @param[in] root expected 32-byte root digest
+ * @return 1 if the proof places the leaf under the root, 0 otherwise
+ */
+int sha256_merkle_verify(const uint8_t leaf[32], size_t index, size_t count,
+                         const uint8_t (*siblings)[32], size_t depth, const uint8_t root[32]);
+
+// Batch of (data, length, expected digest) verification jobs, processed
+// through the multi-buffer kernel in groups of 8
+typedef struct sha256_batch_t {
+    const void **srcs;
+    size_t *lens;
+    const uint8_t **expected;
+    size_t count;
+    size_t cap;
+} sha256_batch_t;
+
+/**
+ * @brief Set up a batch with room for `capacity` jobs
+ *
+ * @param[out] batch batch to initialize
+ * @param[in] capacity maximum number of queued jobs
+ * @return 0 on success, -1 if allocation failed
+ */
+int sha256_batch_init(sha256_batch_t *batch, size_t capacity);
+
+/**
+ * @brief Queue one verification job
+ *
+ * The data and expected digest must stay valid until sha256_batch_run
+ * returns.
+ *
+ * @param[inout] batch target batch
+ * @param[in] src data to hash
+ * @param[in] len number of bytes
+ * @param[in] expected expected 32-byte digest
+ * @return 0 on success, -1 if the batch is full
+ */
+int sha256_batch_push(sha256_batch_t *batch, const void *src, size_t len, const uint8_t expected[32]);
+
+/**
+ * @brief Hash every queued job and compare against its expected digest
+ *
+ * Jobs run through sha256_hash_nway eight at a time, split across
+ * `nthreads` workers. Each result lands in `results` as it completes
+ * (lockstep lanes complete in submission order): 1 for a match, 0 for a
+ * mismatch. The queue is left intact; call sha256_batch_clear to reuse.
+ *
+ * @param[in] batch batch to process
+ * @param[in] nthreads worker thread count (0 or 1 runs on the calling thread)
+ * @param[out] results one int per queued job
+ * @return number of mismatched digests
+ */
+size_t sha256_batch_run(const sha256_batch_t *batch, size_t nthreads, int *results);
+
+/**
+ * @brief Empty the queue, keeping the allocated capacity
+ *
+ * @param[inout] batch batch to clear
+ */
+void sha256_batch_clear(sha256_batch_t *batch);
+
+/**
+ * @brief Release a batch's storage
+ *
+ * @param[inout] batch batch to tear down
+ */
+void sha256_batch_free(sha256_batch_t *batch);
+
+/**
+ * @brief Hash an entire file by path
+ *
+ * Regular files are memory-mapped and hashed in place with sequential
+ * readahead; anything else (or a failed map) streams through a large
+ * read buffer.
+ *
+ * @param[in] path file to hash
+ * @param[out] dst 32-byte destination
+ * @return 0 on success, -1 on I/O or allocation failure (errno is set)
+ */
+int sha256_file(const char *path, void *dst);
+
+// HMAC-SHA256 context: a running inner hash plus the cached midstates of
+// H(K ^ ipad) and H(K ^ opad) so the key schedule is paid once per key
+typedef struct hmac_sha256_t {
+    sha256_t inner;
+    sha256_midstate_t istate;
+    sha256_midstate_t ostate;
+} hmac_sha256_t;
+
+/**
+ * @brief Initialize an HMAC context with a key (RFC 2104)
+ *
+ * Compresses the ipad and opad key blocks once and caches both
+ * midstates; every message afterwards costs only its own data plus two
+ * extra compressions.
+ *
+ * @param[inout] ctx hmac_sha256_t context
+ * @param[in] key MAC key
+ * @param[in] len key length in bytes
+ */
+void hmac_sha256_init(hmac_sha256_t *ctx, const void *key, size_t len);
+
+/**
+ * @brief Append message data to the MAC
+ *
+ * @param[inout] ctx hmac_sha256_t context
+ * @param[in] src data to authenticate
+ * @param[in] len number of bytes to process
+ */
+void hmac_sha256_append(hmac_sha256_t *ctx, const void *src, size_t len);
+
+/**
+ * @brief Finish the MAC and output the 32-byte tag
+ *
+ * @param[inout] ctx hmac_sha256_t context
+ * @param[out] dst 32-byte destination
+ */
+void hmac_sha256_finish(hmac_sha256_t *ctx, void *dst);
+
+/**
+ * @brief Rearm a finished (or partial) context for a new message
+ *
+ * Rewinds to the cached ipad midstate without redoing the key schedule.
+ *
+ * @param[inout] ctx hmac_sha256_t context
+ */
+void hmac_sha256_reset(hmac_sha256_t *ctx);
+
+/**
+ * @brief HKDF-Extract (RFC 5869): condense input keying material to a PRK
+ *
+ * @param[in] salt optional salt, NULL for the RFC's all-zero default
+ * @param[in] salt_len salt length in bytes (ignored when salt is NULL)
+ * @param[in] ikm input keying material
+ * @param[in] ikm_len keying material length in bytes
+ * @param[out] prk 32-byte pseudorandom key
+ */
+void hkdf_sha256_extract(const void *salt, size_t salt_len, const void *ikm, size_t ikm_len, uint8_t *prk);
+
+/**
+ * @brief HKDF-Expand (RFC 5869): stretch a PRK into output keying material
+ *
+ * The PRK's HMAC key schedule runs once up front; the T(1)..T(n)
+ * iterations resume from cached ipad/opad midstates, so each 32-byte
+ * chunk of output costs only the compressions for its own input.
+ *
+ * @param[in] prk 32-byte pseudorandom key from hkdf_sha256_extract
+ * @param[in] info optional context bytes, distinct per derived key
+ * @param[in] info_len context length in bytes
+ * @param[out] okm output keying material
+ * @param[in] okm_len bytes of output wanted, at most 255 * 32
+ * @return 0 on success, -1 if okm_len exceeds the RFC limit
+ */
+int hkdf_sha256_expand(const uint8_t *prk, const void *info, size_t info_len, void *okm, size_t okm_len);
+
+#if defined(__unix__) || defined(__APPLE__)
+/**
+ * @brief Append an iovec chain to the hash
+ *
+ * Equivalent to calling sha256_append per fragment, but stitches blocks
+ * across fragment boundaries internally — full blocks hash straight from
+ * each fragment and the staging buffer is only touched where a fragment
+ * ends mid-block, so callers don't need to coalesce frames first.
+ *
+ * @param[inout] ctx sha256_t context
+ * @param[in] iov fragment array
+ * @param[in] iovcnt number of fragments
+ */
+void sha256_appendv(sha256_t *ctx, const struct iovec *iov, size_t iovcnt);
+
+/**
+ * @brief Hash everything readable from an open file descriptor
+ *
+ * Same strategy as sha256_file. The descriptor is read to EOF and not
+ * closed. Works on pipes and sockets via the streaming path.
+ *
+ * @param[in] fd descriptor to read
+ * @param[out] dst 32-byte destination
+ * @return 0 on success, -1 on I/O or allocation failure (errno is set)
+ */
+int sha256_fd(int fd, void *dst);
+
+// Receives one manifest entry per regular file; entry order is
+// unspecified, but callbacks never overlap
+typedef void (*sha256_manifest_fn)(const char *path, uint64_t size, const uint8_t digest[32], void *arg);
+
+/**
+ * @brief Hash every regular file under a directory tree in parallel
+ *
+ * Walks the tree depth-first, then fans the file list out to a worker
+ * pool pulling batches off a shared cursor. Files up to
+ * SHA256_MANIFEST_SMALL (64 KiB unless overridden) are read whole and
+ * hashed through the multi-buffer kernel eight at a time; larger files
+ * stream through sha256_fd. Symlinks and special files are skipped.
+ * A file that fails to open or read is reported through the return
+ * value, but the remaining entries are still hashed and emitted.
+ *
+ * @param[in] dir root of the tree to hash
+ * @param[in] nthreads worker thread count (0 or 1 hashes on the calling thread)
+ * @param[in] emit callback receiving (path, size, digest) per file
+ * @param[in] arg opaque pointer passed through to the callback
+ * @return 0 when every file hashed cleanly, -1 otherwise
+ */
+int sha256_manifest(const char *dir, size_t nthreads, sha256_manifest_fn emit, void *arg);
+#endif
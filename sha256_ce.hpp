@@ -0,0 +1,206 @@
+/**
+ * @file sha256_ce.hpp
+ * @brief Compile-time SHA-256 for embedding known-good digests
+ * @ref https://nvlpubs.nist.gov/nistpubs/FIPS/NIST.FIPS.180-4.pdf
+ *
+ * Header-only C++14 constexpr implementation of the same round logic as
+ * sha256.c. `constexpr auto h = sha256_ce("...");` folds the digest to a
+ * compile-time constant, so pinned hashes can live in the binary without
+ * a build-time hashing script or any runtime work.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+struct sha256_digest {
+    uint8_t bytes[32];
+
+    constexpr bool operator==(const sha256_digest &other) const
+    {
+        for (size_t i = 0; i < 32; i++) {
+            if (bytes[i] != other.bytes[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr bool operator!=(const sha256_digest &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+namespace sha256_ce_detail
+{
+
+// (3.2.3), (3.2.4)
+constexpr uint32_t shr(uint32_t x, uint32_t n)
+{
+    return x >> n;
+}
+
+constexpr uint32_t rotr(uint32_t x, uint32_t n)
+{
+    return (x >> n) | (x << (0x20 - n));
+}
+
+// (4.2) - (4.7)
+constexpr uint32_t ch(uint32_t x, uint32_t y, uint32_t z)
+{
+    return (x & y) ^ (~x & z);
+}
+
+constexpr uint32_t maj(uint32_t x, uint32_t y, uint32_t z)
+{
+    return (x & y) ^ (x & z) ^ (y & z);
+}
+
+constexpr uint32_t sum0(uint32_t x)
+{
+    return rotr(x, 0x02) ^ rotr(x, 0x0d) ^ rotr(x, 0x16);
+}
+
+constexpr uint32_t sum1(uint32_t x)
+{
+    return rotr(x, 0x06) ^ rotr(x, 0x0b) ^ rotr(x, 0x19);
+}
+
+constexpr uint32_t sig0(uint32_t x)
+{
+    return rotr(x, 0x07) ^ rotr(x, 0x12) ^ shr(x, 0x03);
+}
+
+constexpr uint32_t sig1(uint32_t x)
+{
+    return rotr(x, 0x11) ^ rotr(x, 0x13) ^ shr(x, 0x0a);
+}
+
+// (4.2.2)
+constexpr uint32_t k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+struct state_t {
+    uint32_t h[8];
+};
+
+// (6.2.2) over one 64-byte block already split out by the caller
+constexpr state_t compress(state_t st, const uint8_t block[64])
+{
+    // Message schedule (6.2.2.1)
+    uint32_t w[64] = {};
+    for (size_t i = 0; i < 16; i++) {
+        w[i] = (uint32_t)block[4 * i + 0] << 0x18 |
+               (uint32_t)block[4 * i + 1] << 0x10 |
+               (uint32_t)block[4 * i + 2] << 0x08 |
+               (uint32_t)block[4 * i + 3] << 0x00;
+    }
+    for (size_t i = 16; i < 64; i++) {
+        w[i] = sig1(w[i - 0x02]) + sig0(w[i - 0x0f]) + w[i - 0x07] + w[i - 0x10];
+    }
+
+    // (6.2.2.2) - (6.2.2.3)
+    uint32_t a = st.h[0];
+    uint32_t b = st.h[1];
+    uint32_t c = st.h[2];
+    uint32_t d = st.h[3];
+    uint32_t e = st.h[4];
+    uint32_t f = st.h[5];
+    uint32_t g = st.h[6];
+    uint32_t h = st.h[7];
+
+    for (size_t i = 0; i < 64; i++) {
+        const uint32_t t1 = h + sum1(e) + ch(e, f, g) + k[i] + w[i];
+        const uint32_t t2 = sum0(a) + maj(a, b, c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    // (6.2.2.4)
+    return state_t {
+        { st.h[0] + a, st.h[1] + b, st.h[2] + c, st.h[3] + d,
+          st.h[4] + e, st.h[5] + f, st.h[6] + g, st.h[7] + h }
+    };
+}
+
+} // namespace sha256_ce_detail
+
+/**
+ * @brief Compile-time hash of an arbitrary byte range
+ *
+ * @param[in] data bytes to hash (any constexpr-readable pointer)
+ * @param[in] len number of bytes
+ * @return 32-byte digest, usable in constexpr context
+ */
+constexpr sha256_digest sha256_ce(const char *data, size_t len)
+{
+    using namespace sha256_ce_detail;
+
+    // (5.3.2)
+    state_t st = {
+        { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+          0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 }
+    };
+
+    uint8_t block[64] = {};
+    size_t fill = 0;
+    for (size_t i = 0; i < len; i++) {
+        block[fill++] = (uint8_t)data[i];
+        if (fill == 64) {
+            st = compress(st, block);
+            fill = 0;
+        }
+    }
+
+    // Padding (5.1.1)
+    block[fill++] = 128;
+    if (fill > 56) {
+        for (size_t i = fill; i < 64; i++) {
+            block[i] = 0;
+        }
+        st = compress(st, block);
+        fill = 0;
+    }
+    for (size_t i = fill; i < 64; i++) {
+        block[i] = 0;
+    }
+    const uint64_t bits = 8 * (uint64_t)len;
+    for (size_t i = 0; i < 8; i++) {
+        block[63 - i] = (uint8_t)(bits >> (8 * i));
+    }
+    st = compress(st, block);
+
+    sha256_digest digest = {};
+    for (size_t i = 0; i < 8; i++) {
+        digest.bytes[4 * i + 0] = (uint8_t)(st.h[i] >> 0x18);
+        digest.bytes[4 * i + 1] = (uint8_t)(st.h[i] >> 0x10);
+        digest.bytes[4 * i + 2] = (uint8_t)(st.h[i] >> 0x08);
+        digest.bytes[4 * i + 3] = (uint8_t)(st.h[i] >> 0x00);
+    }
+    return digest;
+}
+
+/**
+ * @brief Compile-time hash of a string literal (trailing NUL excluded)
+ */
+template <size_t N>
+constexpr sha256_digest sha256_ce(const char (&str)[N])
+{
+    return sha256_ce(str, N - 1);
+}
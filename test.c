@@ -0,0 +1,512 @@
+/**
+ * @file test.c
+ * @brief Self-test suite for the `test` make target
+ *
+ * FIPS 180-4 known-answer tests, incremental-vs-one-shot split fuzzing,
+ * cross-backend equivalence (the scalar core against whatever the
+ * dispatcher picked, plus the multi-buffer kernel), serialization
+ * round-trips, and a bulk-path throughput smoke check. Includes
+ * sha256.c directly so the static backend kernels are reachable.
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "sha256.c"
+
+static size_t failures;
+
+#define CHECK(cond, ...)                          \
+    do {                                          \
+        if (!(cond)) {                            \
+            failures++;                           \
+            printf("FAIL %s:%d: ", __func__, __LINE__); \
+            printf(__VA_ARGS__);                  \
+            printf("\n");                         \
+        }                                         \
+    } while (0)
+
+static void hexdigest(const uint8_t *digest, size_t len, char *out)
+{
+    for (size_t i = 0; i < len; i++) {
+        sprintf(&out[2 * i], "%02x", digest[i]);
+    }
+}
+
+static uint32_t test_rand_state = 0x1badb002;
+
+static uint32_t test_rand(void)
+{
+    // xorshift — deterministic across platforms
+    test_rand_state ^= test_rand_state << 13;
+    test_rand_state ^= test_rand_state >> 17;
+    test_rand_state ^= test_rand_state << 5;
+    return test_rand_state;
+}
+
+// FIPS 180-4 known-answer tests (one-shot and streaming must agree)
+static void test_kat(void)
+{
+    static const struct {
+        const char *msg;
+        size_t repeat;
+        const char *hex;
+    } vectors[] = {
+        { "", 1, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+        { "abc", 1, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+        { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1,
+          "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+        { "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu", 1,
+          "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1" },
+        { "a", 1000000, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" },
+    };
+
+    for (size_t t = 0; t < sizeof(vectors) / sizeof(vectors[0]); t++) {
+        sha256_t ctx;
+        sha256_init(&ctx);
+        for (size_t r = 0; r < vectors[t].repeat; r++) {
+            sha256_append(&ctx, vectors[t].msg, strlen(vectors[t].msg));
+        }
+        uint8_t digest[32];
+        char hex[65];
+        sha256_finish(&ctx, digest);
+        hexdigest(digest, 32, hex);
+        CHECK(!strcmp(hex, vectors[t].hex), "vector %zu: %s", t, hex);
+    }
+
+    // SHA-224 and double-SHA-256 vectors
+    uint8_t d28[28];
+    char hex[65];
+    sha224("abc", 3, d28);
+    hexdigest(d28, 28, hex);
+    CHECK(!strcmp(hex, "23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7"), "sha224 abc: %s", hex);
+
+    uint8_t d32[32];
+    sha256d("", 0, d32);
+    hexdigest(d32, 32, hex);
+    CHECK(!strcmp(hex, "5df6e0e2761359d30a8275058e299fcc0381534545f55cf43e41983f5d4c9456"), "sha256d: %s", hex);
+
+    // HMAC-SHA256, RFC 4231 case 2
+    hmac_sha256_t mac;
+    hmac_sha256_init(&mac, "Jefe", 4);
+    hmac_sha256_append(&mac, "what do ya want for nothing?", 28);
+    hmac_sha256_finish(&mac, d32);
+    hexdigest(d32, 32, hex);
+    CHECK(!strcmp(hex, "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"), "hmac: %s", hex);
+
+    // HKDF-SHA256, RFC 5869 case 1
+    uint8_t ikm[22];
+    uint8_t salt[13];
+    uint8_t info[10];
+    memset(ikm, 0x0b, sizeof(ikm));
+    for (size_t i = 0; i < sizeof(salt); i++) {
+        salt[i] = (uint8_t)i;
+    }
+    for (size_t i = 0; i < sizeof(info); i++) {
+        info[i] = (uint8_t)(0xf0 + i);
+    }
+    uint8_t prk[32];
+    uint8_t okm[42];
+    char okm_hex[85];
+    hkdf_sha256_extract(salt, sizeof(salt), ikm, sizeof(ikm), prk);
+    hexdigest(prk, 32, hex);
+    CHECK(!strcmp(hex, "077709362c2e32df0ddc3f0dc47bba6390b6c73bb50f9c3122ec844ad7c2b3e5"), "hkdf prk: %s", hex);
+    CHECK(!hkdf_sha256_expand(prk, info, sizeof(info), okm, sizeof(okm)), "hkdf expand rc");
+    hexdigest(okm, sizeof(okm), okm_hex);
+    CHECK(!strcmp(okm_hex, "3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf34007208d5b887185865"),
+          "hkdf okm: %s", okm_hex);
+
+    // HKDF-SHA256, RFC 5869 case 3 (no salt, no info)
+    hkdf_sha256_extract(NULL, 0, ikm, sizeof(ikm), prk);
+    CHECK(!hkdf_sha256_expand(prk, NULL, 0, okm, sizeof(okm)), "hkdf expand rc (case 3)");
+    hexdigest(okm, sizeof(okm), okm_hex);
+    CHECK(!strcmp(okm_hex, "8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d9d201395faa4b61a96c8"),
+          "hkdf okm (case 3): %s", okm_hex);
+    CHECK(hkdf_sha256_expand(prk, NULL, 0, okm, 255 * 32 + 1) == -1, "hkdf okm_len limit");
+}
+
+// Any split of the input across append calls must match the one-shot
+static void test_split_fuzz(void)
+{
+    static uint8_t buf[8192];
+    for (int iter = 0; iter < 2000; iter++) {
+        const size_t len = test_rand() % sizeof(buf);
+        for (size_t i = 0; i < len; i++) {
+            buf[i] = (uint8_t)test_rand();
+        }
+
+        uint8_t ref[32];
+        sha256(buf, len, ref);
+
+        sha256_t ctx;
+        sha256_init(&ctx);
+        size_t off = 0;
+        while (off < len) {
+            size_t n = test_rand() % 257 + 1;
+            if (n > len - off) {
+                n = len - off;
+            }
+            sha256_append(&ctx, &buf[off], n);
+            off += n;
+        }
+        CHECK(sha256_verify(&ctx, ref), "iter %d len %zu", iter, len);
+    }
+}
+
+// Scalar core, dispatched backend, and multi-buffer kernel must agree
+static void test_backends(void)
+{
+#if SHA256_KERNEL_SCALAR
+    static uint8_t blocks[64 * 64];
+    for (int iter = 0; iter < 200; iter++) {
+        const size_t nblocks = test_rand() % 64 + 1;
+        for (size_t i = 0; i < 64 * nblocks; i++) {
+            blocks[i] = (uint8_t)test_rand();
+        }
+
+        uint32_t scalar[8];
+        uint32_t dispatched[8];
+        memcpy(scalar, sha256_iv, sizeof(sha256_iv));
+        memcpy(dispatched, sha256_iv, sizeof(sha256_iv));
+        sha256_compress_scalar(scalar, blocks, nblocks);
+        sha256_compress(dispatched, blocks, nblocks);
+        CHECK(!memcmp(scalar, dispatched, sizeof(scalar)),
+              "%s diverged from scalar at %zu blocks", sha256_backend(), nblocks);
+    }
+#endif
+
+    // nway against single-stream, mixed lengths around block/pad edges
+    static uint8_t msgs[16][300];
+    const void *srcs[16];
+    size_t lens[16];
+    static const size_t edges[] = { 0, 1, 55, 56, 63, 64, 65, 119, 120, 127, 128, 129, 200, 255, 256, 299 };
+    for (size_t i = 0; i < 16; i++) {
+        lens[i] = edges[i];
+        for (size_t j = 0; j < lens[i]; j++) {
+            msgs[i][j] = (uint8_t)test_rand();
+        }
+        srcs[i] = msgs[i];
+    }
+    uint8_t digests[16][32];
+    sha256_hash_nway(srcs, lens, 16, digests);
+    for (size_t i = 0; i < 16; i++) {
+        uint8_t ref[32];
+        sha256(srcs[i], lens[i], ref);
+        CHECK(!memcmp(digests[i], ref, 32), "nway lane %zu len %zu", i, lens[i]);
+    }
+
+    // interleaved two-stream kernel
+    uint8_t da[64], db[64];
+    for (size_t i = 0; i < 64; i++) {
+        da[i] = (uint8_t)test_rand();
+        db[i] = (uint8_t)test_rand();
+    }
+    sha256_t a, b, ra, rb;
+    sha256_init(&a);
+    sha256_init(&b);
+    sha256_hash2(&a, da, &b, db);
+    uint8_t d1[32], d2[32], r1[32], r2[32];
+    sha256_finish(&a, d1);
+    sha256_finish(&b, d2);
+    sha256_init(&ra);
+    sha256_append(&ra, da, 64);
+    sha256_finish(&ra, r1);
+    sha256_init(&rb);
+    sha256_append(&rb, db, 64);
+    sha256_finish(&rb, r2);
+    CHECK(!memcmp(d1, r1, 32) && !memcmp(d2, r2, 32), "hash2");
+}
+
+typedef struct chunk_ctx_t {
+    const uint8_t *buf;
+    size_t total;
+    uint64_t next;
+    size_t count;
+    size_t cuts[4];
+} chunk_ctx_t;
+
+static void chunk_record(uint64_t offset, size_t len, const uint8_t digest[32], void *arg)
+{
+    chunk_ctx_t *c = (chunk_ctx_t *)arg;
+    CHECK(offset == c->next, "gap at offset %llu", (unsigned long long)offset);
+    CHECK(len <= 16384, "chunk over max_len: %zu", len);
+    CHECK(len >= 1024 || offset + len == c->total, "chunk under min_len: %zu", len);
+
+    uint8_t ref[32];
+    sha256(&c->buf[offset], len, ref);
+    CHECK(!memcmp(digest, ref, 32), "chunk digest at offset %llu", (unsigned long long)offset);
+
+    if (c->count < 4) {
+        c->cuts[c->count] = (size_t)(offset + len);
+    }
+    c->count++;
+    c->next = offset + len;
+}
+
+// Chunks must tile the buffer, honor the [min, max] clamp, carry the
+// digest of their own range, and cut in the same places every time —
+// the gear table is frozen precisely so boundaries survive rebuilds
+static void test_chunks(void)
+{
+    static uint8_t buf[256 * 1024];
+    uint32_t seed = 0x6a09e667;
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        buf[i] = (uint8_t)seed;
+    }
+
+    chunk_ctx_t c = { .buf = buf, .total = sizeof(buf) };
+    CHECK(!sha256_chunks(buf, sizeof(buf), 1024, 4096, 16384, chunk_record, &c), "chunks rc");
+    CHECK(c.next == sizeof(buf), "chunks don't tile the buffer");
+
+    // Pinned against the frozen gear table and boundary mask
+    static const size_t expect_cuts[4] = { 4844, 7549, 17445, 28152 };
+    CHECK(c.count == 61, "cut count drifted: %zu", c.count);
+    for (size_t i = 0; i < 4; i++) {
+        CHECK(c.cuts[i] == expect_cuts[i], "cut %zu drifted: %zu", i, c.cuts[i]);
+    }
+
+    // Second pass must reproduce the first exactly
+    chunk_ctx_t again = { .buf = buf, .total = sizeof(buf) };
+    CHECK(!sha256_chunks(buf, sizeof(buf), 1024, 4096, 16384, chunk_record, &again), "chunks rc");
+    CHECK(again.count == c.count, "cut sequence not deterministic");
+
+    CHECK(sha256_chunks(buf, sizeof(buf), 0, 4096, 16384, chunk_record, &c) == -1, "min_len 0");
+    CHECK(sha256_chunks(buf, sizeof(buf), 8192, 4096, 16384, chunk_record, &c) == -1, "min > avg");
+    CHECK(sha256_chunks(buf, sizeof(buf), 1024, 32768, 16384, chunk_record, &c) == -1, "avg > max");
+    CHECK(sha256_chunks(buf, sizeof(buf), 1024, 4096, 16384, NULL, NULL) == -1, "NULL callback");
+}
+
+// Clone, midstate, export/import, and streaming variants
+static void test_state_roundtrips(void)
+{
+    static uint8_t buf[4096];
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)test_rand();
+    }
+
+    for (int iter = 0; iter < 200; iter++) {
+        const size_t split = test_rand() % sizeof(buf);
+        uint8_t ref[32];
+        sha256(buf, sizeof(buf), ref);
+
+        sha256_t ctx;
+        sha256_init(&ctx);
+        sha256_append(&ctx, buf, split);
+
+        uint8_t blob[SHA256_EXPORT_SIZE];
+        sha256_export(&ctx, blob);
+        sha256_t resumed;
+        CHECK(!sha256_import(&resumed, blob), "import split %zu", split);
+        sha256_append(&resumed, &buf[split], sizeof(buf) - split);
+        CHECK(sha256_verify(&resumed, ref), "export/import split %zu", split);
+
+        sha256_t cloned;
+        sha256_clone(&ctx, &cloned);
+        sha256_append(&cloned, &buf[split], sizeof(buf) - split);
+        CHECK(sha256_verify(&cloned, ref), "clone split %zu", split);
+    }
+
+    // append_stream must match append above and below the threshold
+    const size_t big = SHA256_STREAM_THRESHOLD + 12345;
+    uint8_t *huge = malloc(big);
+    if (huge) {
+        for (size_t i = 0; i < big; i++) {
+            huge[i] = (uint8_t)test_rand();
+        }
+        uint8_t ref[32];
+        sha256(huge, big, ref);
+        sha256_t ctx;
+        sha256_init(&ctx);
+        sha256_append(&ctx, huge, 7);
+        sha256_append_stream(&ctx, &huge[7], big - 7);
+        CHECK(sha256_verify(&ctx, ref), "append_stream");
+        free(huge);
+    }
+
+    // tree hash must not depend on the thread count
+    uint8_t t1[32], t4[32];
+    CHECK(!sha256_tree(buf, sizeof(buf), 1, t1), "tree serial");
+    CHECK(!sha256_tree(buf, sizeof(buf), 4, t4), "tree threaded");
+    CHECK(!memcmp(t1, t4, 32), "tree thread-count invariance");
+}
+
+// Independent pair-and-promote reference root, reducing in place
+static void merkle_ref_root(uint8_t (*nodes)[32], size_t count, uint8_t *dst)
+{
+    while (count > 1) {
+        for (size_t i = 0; 2 * i < count; i++) {
+            if (2 * i + 1 < count) {
+                uint8_t pair[64];
+                memcpy(&pair[0], nodes[2 * i + 0], 32);
+                memcpy(&pair[32], nodes[2 * i + 1], 32);
+                sha256(pair, 64, nodes[i]);
+            }
+            else {
+                memcpy(nodes[i], nodes[2 * i], 32);
+            }
+        }
+        count = (count + 1) / 2;
+    }
+    memcpy(dst, nodes[0], 32);
+}
+
+// Incremental roots must match the reference at every count — odd
+// counts exercise the promotion paths — and proofs must verify for
+// every leaf while rejecting any forged leaf, index, or truncation
+static void test_merkle(void)
+{
+    enum { MERKLE_LEAVES = 130 };
+    static uint8_t leaves[MERKLE_LEAVES][32];
+    static uint8_t scratch[MERKLE_LEAVES][32];
+    for (size_t i = 0; i < MERKLE_LEAVES; i++) {
+        for (size_t j = 0; j < 32; j++) {
+            leaves[i][j] = (uint8_t)test_rand();
+        }
+    }
+
+    sha256_merkle_t tree;
+    sha256_merkle_init(&tree);
+
+    uint8_t root[32];
+    uint8_t expect[32];
+    sha256_merkle_root(&tree, root);
+    memset(expect, 0, 32);
+    CHECK(!memcmp(root, expect, 32), "empty root not zero");
+
+    for (size_t count = 1; count <= MERKLE_LEAVES; count++) {
+        CHECK(!sha256_merkle_append(&tree, leaves[count - 1]), "append %zu", count);
+        sha256_merkle_root(&tree, root);
+        memcpy(scratch, leaves, count * 32);
+        merkle_ref_root(scratch, count, expect);
+        CHECK(!memcmp(root, expect, 32), "root diverges at %zu leaves", count);
+    }
+
+    sha256_merkle_root(&tree, root);
+    for (size_t i = 0; i < MERKLE_LEAVES; i++) {
+        uint8_t siblings[SHA256_MERKLE_DEPTH][32];
+        size_t depth;
+        CHECK(!sha256_merkle_proof(&tree, i, siblings, &depth), "proof %zu", i);
+        CHECK(sha256_merkle_verify(leaves[i], i, MERKLE_LEAVES, siblings, depth, root),
+              "proof %zu doesn't verify", i);
+        CHECK(!sha256_merkle_verify(leaves[(i + 1) % MERKLE_LEAVES], i, MERKLE_LEAVES, siblings, depth, root),
+              "forged leaf accepted at %zu", i);
+        CHECK(!sha256_merkle_verify(leaves[i], (i + 1) % MERKLE_LEAVES, MERKLE_LEAVES, siblings, depth, root),
+              "forged index accepted at %zu", i);
+        if (depth) {
+            CHECK(!sha256_merkle_verify(leaves[i], i, MERKLE_LEAVES, siblings, depth - 1, root),
+                  "truncated proof accepted at %zu", i);
+        }
+    }
+    CHECK(!sha256_merkle_verify(leaves[0], 0, MERKLE_LEAVES, NULL, 0, leaves[1]), "wrong root accepted");
+    CHECK(sha256_merkle_proof(&tree, MERKLE_LEAVES, NULL, NULL) == -1, "out-of-range proof");
+    sha256_merkle_free(&tree);
+}
+
+// The fixed-length one-shot must agree with the general one-shot for
+// every input, and the tree reduce built on top of it must match both
+// an independent reference and a pinned root — scalar builds route
+// through the precomputed padding schedule in sha256_block64_finish
+static void test_block64(void)
+{
+    for (size_t iter = 0; iter < 500; iter++) {
+        uint8_t block[64];
+        for (size_t i = 0; i < sizeof(block); i++) {
+            block[i] = (uint8_t)test_rand();
+        }
+        uint8_t expect[32], digest[32];
+        sha256(block, sizeof(block), expect);
+        sha256_block64(block, digest);
+        CHECK(!memcmp(digest, expect, 32), "block64 diverges at iteration %zu", iter);
+    }
+
+    // Three leaves — two full, one short, one promotion — against a
+    // reference reduced with the general one-shot
+    const size_t leaf = 1024 * 1024;
+    const size_t len = 2 * leaf + leaf / 2;
+    uint8_t *buf = malloc(len);
+    if (!buf) {
+        return;
+    }
+    uint32_t seed = 0xc67178f2;
+    for (size_t i = 0; i < len; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        buf[i] = (uint8_t)seed;
+    }
+
+    uint8_t digests[3][32];
+    sha256(&buf[0], leaf, digests[0]);
+    sha256(&buf[leaf], leaf, digests[1]);
+    sha256(&buf[2 * leaf], leaf / 2, digests[2]);
+    uint8_t expect[32];
+    merkle_ref_root(digests, 3, expect);
+
+    uint8_t root[32];
+    CHECK(!sha256_tree(buf, len, 2, root), "tree");
+    CHECK(!memcmp(root, expect, 32), "tree root diverges from reference");
+
+    char hex[65];
+    hexdigest(root, 32, hex);
+    CHECK(!strcmp(hex, "235ab388d3b6e47251fefb52973371fdb848e803d1542df9a1e31dfa5bf3a33b"),
+          "tree root diverges from pinned value");
+    free(buf);
+}
+
+// The bulk path must actually be a bulk path: hashing one large append
+// has to clearly beat feeding the same data one byte at a time
+static void test_bulk_throughput(void)
+{
+    const size_t len = 4 * 1024 * 1024;
+    uint8_t *buf = malloc(len);
+    if (!buf) {
+        return;
+    }
+    memset(buf, 0x5a, len);
+
+    struct timespec t0, t1;
+    uint8_t digest[32];
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    sha256_t bulk;
+    sha256_init(&bulk);
+    sha256_append(&bulk, buf, len);
+    sha256_finish(&bulk, digest);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    const double bulk_ns = (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    sha256_t slow;
+    sha256_init(&slow);
+    for (size_t i = 0; i < len / 16; i++) { // 1/16th of the data, one byte at a time
+        sha256_append(&slow, &buf[i], 1);
+    }
+    sha256_finish(&slow, digest);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    const double slow_ns = 16.0 * ((double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec));
+
+    CHECK(bulk_ns * 1.5 < slow_ns, "bulk path regression: bulk %.0f ns vs per-byte %.0f ns", bulk_ns, slow_ns);
+    free(buf);
+}
+
+int main(void)
+{
+    test_kat();
+    test_split_fuzz();
+    test_backends();
+    test_chunks();
+    test_merkle();
+    test_block64();
+    test_state_roundtrips();
+    test_bulk_throughput();
+
+    if (failures) {
+        printf("%zu failure(s)\n", failures);
+        return 1;
+    }
+    printf("all tests passed (backend: %s)\n", sha256_backend());
+    return 0;
+}